@@ -0,0 +1,19 @@
+#pragma once
+
+#include <QString>
+
+namespace cc {
+namespace neolux {
+namespace fem {
+namespace xlsxeditor {
+
+/** @brief 列字母转为 1-based 列号（不区分大小写，忽略首尾空白）。 */
+int columnNumber(const QString& col);
+
+/** @brief 1-based 列号转为列字母。 */
+QString columnName(int num);
+
+}  // namespace xlsxeditor
+}  // namespace fem
+}  // namespace neolux
+}  // namespace cc
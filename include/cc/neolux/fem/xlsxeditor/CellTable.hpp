@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cc {
+namespace neolux {
+namespace fem {
+namespace xlsxeditor {
+
+/** @brief 工作表中的矩形区域（1-based，首尾均包含）。 */
+struct CellRange {
+    int firstRow;
+    int firstCol;
+    int lastRow;
+    int lastCol;
+
+    /** @brief 单元格是否落在区域内。 */
+    bool contains(int row, int col) const {
+        return row >= firstRow && row <= lastRow && col >= firstCol && col <= lastCol;
+    }
+};
+
+/**
+ * @brief 单元格文本与样式索引的紧凑表。
+ *
+ * 只保存有内容或非默认样式的单元格，按 (row, col) 打包键有序排列，查找为二分。
+ * 由 XLSXPackage::readCells 一次性填充，之后只读，可跨线程传递。
+ */
+class CellTable {
+public:
+    /** @brief 清空。 */
+    void clear() { m_cells.clear(); }
+
+    /** @brief 是否为空。 */
+    bool isEmpty() const { return m_cells.empty(); }
+
+    /** @brief 单元格数量。 */
+    size_t size() const { return m_cells.size(); }
+
+    /** @brief 估算占用的字节数（表本身与超出短字符串优化的文本）。 */
+    size_t byteSize() const;
+
+    /**
+     * @brief 写入单元格，已存在时覆盖。
+     *
+     * 按行优先顺序写入时为追加，乱序写入退化为有序插入。
+     * @param styleIndex 单元格的 cellXfs 样式索引（c@s），0 为默认样式。
+     */
+    void insert(int row, int col, std::string text, int styleIndex = 0);
+
+    /**
+     * @brief 获取单元格文本。
+     * @return 文本，单元格不存在时返回空串。
+     */
+    const std::string& text(int row, int col) const;
+
+    /**
+     * @brief 获取单元格样式索引。
+     * @return cellXfs 索引，单元格不存在时返回 0。
+     */
+    int styleIndex(int row, int col) const;
+
+    /** @brief 打包后的 (row, col) 键，行优先有序。 */
+    static std::uint64_t key(int row, int col) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(row)) << 32) |
+               static_cast<std::uint32_t>(col);
+    }
+
+private:
+    struct Cell {
+        std::uint64_t key;
+        std::string text;
+        int styleIndex;
+    };
+
+    std::vector<Cell> m_cells;
+
+    const Cell* find(int row, int col) const;
+};
+
+}  // namespace xlsxeditor
+}  // namespace fem
+}  // namespace neolux
+}  // namespace cc
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QByteArray>
+#include <QSize>
+#include <QString>
+#include <string>
+
+#include "cc/neolux/fem/xlsxeditor/ImagePyramid.hpp"
+
+namespace cc {
+namespace neolux {
+namespace fem {
+namespace xlsxeditor {
+
+/**
+ * @brief 单个数据项（图片 + 描述）的内存表示。
+ *
+ * row/col 使用工作表中的 1-based 行列坐标。
+ * 仅常驻原始压缩数据与网格缩略图金字塔，全分辨率图片经 ImageCache 按需解码。
+ * 缩略图来自磁盘缓存时 bytes 为空，首次需要全分辨率时再按 mediaPath 从包中读取。
+ * 加载过程中布局先于图片就绪，此时 pending 为 true，图片字段随解码逐批填入；
+ * 关闭加载解码时 pending 保持为 true。
+ */
+struct DataEntry {
+    int row, col;
+    QByteArray bytes;         // 原始压缩图片数据
+    std::string mediaPath;    // 图片在包内的路径
+    QSize imageSize;          // 原图尺寸，解码失败时为空
+    ImagePyramid thumbnails;  // 网格图标用缩略图金字塔
+    QString desc;
+    bool deleted;
+    QString origDesc;  // 源文件中的描述，保存时据此判断是否需要写回
+    bool origFilled;   // 源文件中描述单元格是否带背景填充（如已有删除标记）
+    bool pending = false;  // 图片尚未解码
+
+    /** @brief 图片是否可用。 */
+    bool hasImage() const { return !imageSize.isEmpty(); }
+
+    /** @brief 是否在网格中占位：图片可用或尚未解码（解码失败的项不显示）。 */
+    bool inGrid() const { return pending || hasImage(); }
+
+    /** @brief 描述单元格是否与源文件状态不同，需要在保存时写回。 */
+    bool differsFromSource() const { return deleted || origFilled || desc != origDesc; }
+};
+
+}  // namespace xlsxeditor
+}  // namespace fem
+}  // namespace neolux
+}  // namespace cc
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <QCache>
+#include <QPixmap>
+#include <QString>
+#include <QVector>
+#include <QWidget>
+
+#include "cc/neolux/fem/xlsxeditor/DataEntry.hpp"
+
+class QLineEdit;
+
+namespace cc {
+namespace neolux {
+namespace fem {
+namespace xlsxeditor {
+
+/**
+ * @brief 虚拟化的数据项网格。
+ *
+ * 单个自绘组件替代“每张图片一个 DataItem”，只绘制与重绘区域相交的单元格与表头，
+ * 不为数据项创建任何子组件。交互与 DataItem 保持一致：
+ * - 描述区双击切换删除状态，右键菜单标记/修改值
+ * - 图片区中键点击请求预览
+ * - 行/列表头双击批量切换
+ */
+class DataGridWidget : public QWidget {
+    Q_OBJECT
+
+public:
+    /** @brief 一条行或列表头。 */
+    struct Axis {
+        int index;      // 工作表行号/列号（1-based）
+        QString outer;  // 外层表头文本
+        QString inner;  // 内层 dose/focus 表头文本，单层表头时忽略
+    };
+
+    /**
+     * @brief 构造函数。
+     * @param parent 父级 QWidget。
+     */
+    explicit DataGridWidget(QWidget* parent = nullptr);
+
+    /**
+     * @brief 设置网格内容。
+     * @param entries 数据项数组，由调用方持有，需在下次 setGrid/clear 前保持有效。
+     * @param rows 按显示顺序排列的行表头。
+     * @param cols 按显示顺序排列的列表头。
+     * @param twoLayerHeaders 是否显示 dose/focus 双层表头。
+     */
+    void setGrid(const QVector<DataEntry>* entries, const QVector<Axis>& rows,
+                 const QVector<Axis>& cols, bool twoLayerHeaders);
+
+    /** @brief 清空网格。 */
+    void clear();
+
+    /**
+     * @brief 设置缩放比例。
+     * @param scale 缩放因子，限制在 0.5~2.5。
+     */
+    void setItemScale(double scale);
+
+    /**
+     * @brief 设置预览模式。
+     * @param previewOnly true 时不显示已标记删除的项（保留其占位）。
+     */
+    void setPreviewOnly(bool previewOnly);
+
+    /**
+     * @brief 重绘单个数据项。
+     * @param index 数据项索引。
+     */
+    void refreshEntry(int index);
+
+    /**
+     * @brief 单元格与给定矩形相交的数据项（预览模式下隐藏的项除外）。
+     * @param rect 本组件坐标系中的矩形。
+     * @return 数据项索引，按行优先排列。
+     */
+    QVector<int> entriesIn(const QRect& rect) const;
+
+    /** @brief 按当前缩放与表头计算的内容尺寸。 */
+    QSize contentSize() const;
+
+    /** @brief 图标缓存当前占用的字节数。 */
+    qint64 iconCacheBytes() const { return m_iconCache.totalCost(); }
+
+    /**
+     * @brief 限制图标缓存的字节数，超出部分立即淘汰；为零时图标每次绘制时重新缩放。
+     * @param limitBytes 字节上限，-1 恢复默认上限；不会超过默认上限。
+     */
+    void setIconCacheLimit(qint64 limitBytes);
+
+    /**
+     * @brief 数据项图片区域在屏幕全局坐标系中的矩形。
+     * @param index 数据项索引。
+     * @return 矩形，数据项不在网格中时为空。
+     */
+    QRect imageGlobalRect(int index) const;
+
+signals:
+    /**
+     * @brief 请求切换数据项删除状态（描述区双击或右键菜单）。
+     * @param index 数据项索引。
+     */
+    void toggleRequested(int index);
+
+    /**
+     * @brief 描述值被修改时发射。
+     * @param index 数据项索引。
+     * @param text 修改后的文本。
+     */
+    void descriptionEdited(int index, const QString& text);
+
+    /**
+     * @brief 图片区域收到中键点击时发射（用于触发预览）。
+     * @param row 工作表行号（1-based）。
+     * @param col 工作表列号（1-based）。
+     */
+    void imagePreviewRequested(int row, int col);
+
+    /**
+     * @brief 行/列表头被双击时发射。
+     * @param axis "row" 或 "col"。
+     * @param index 工作表行号/列号（1-based）。
+     */
+    void headerDoubleClicked(const QString& axis, int index);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseDoubleClickEvent(QMouseEvent* event) override;
+    bool event(QEvent* event) override;
+
+private:
+    /** @brief 命中测试结果。 */
+    struct Hit {
+        enum Kind { None, Image, Description, RowHeader, ColHeader } kind;
+        int index;  // Image/Description 为数据项索引，表头为工作表行/列号
+    };
+
+    /** @brief 当前缩放下的尺寸参数。 */
+    struct Metrics {
+        int itemW, itemH;
+        int headerW, headerH;
+        int innerHeaderW;
+        int bandW, bandH;  // 表头区域总宽/总高
+        int contentSize, iconSize, innerGap;
+        QRect imageRect;  // 相对单元格左上角
+        QRect textRect;   // 相对单元格左上角
+    };
+
+    const QVector<DataEntry>* m_entries;
+    QVector<Axis> m_rows;
+    QVector<Axis> m_cols;
+    QVector<int> m_cellAt;       // [gridRow * cols + gridCol] -> 数据项索引，空位为 -1
+    QVector<int> m_slotOfEntry;  // 数据项索引 -> 网格位置，不在网格中为 -1
+    bool m_twoLayerHeaders;
+    bool m_previewOnly;
+    double m_scale;
+    Metrics m_metrics;
+    qreal m_basePointSize;
+    /** @brief 当前缩放下的图标缓存，仅包含绘制过的单元格。 */
+    mutable QCache<int, QPixmap> m_iconCache;
+    QLineEdit* m_editor;
+    int m_editingIndex;
+
+    void updateMetrics();
+    QFont itemFont() const;
+    QRect cellRect(int slot) const;
+    Hit hitTest(const QPoint& pos) const;
+    bool isEntryVisible(int index) const;
+    QPixmap iconFor(int index) const;
+    void paintCell(QPainter& painter, int slot, int index) const;
+    void paintHeaders(QPainter& painter, const QRect& dirty) const;
+    void showContextMenu(int index, const QPoint& globalPos);
+    void beginEdit(int index);
+    void commitEdit();
+};
+
+}  // namespace xlsxeditor
+}  // namespace fem
+}  // namespace neolux
+}  // namespace cc
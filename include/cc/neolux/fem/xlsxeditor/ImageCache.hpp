@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QByteArray>
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+
+namespace cc {
+namespace neolux {
+namespace fem {
+namespace xlsxeditor {
+
+/**
+ * @brief 按字节预算淘汰的全分辨率图片缓存（LRU）。
+ *
+ * 以数据项索引为键保存解码结果，总占用超过预算时淘汰最久未使用的图片。
+ * 所有接口均加锁，可在工作线程中预取；解码本身在锁外进行。
+ */
+class ImageCache {
+public:
+    /** @brief 默认预算：256 MB。 */
+    static constexpr qint64 kDefaultBudgetBytes = 256LL * 1024 * 1024;
+
+    /**
+     * @brief 构造缓存。
+     * @param budgetBytes 字节预算。
+     */
+    explicit ImageCache(qint64 budgetBytes = kDefaultBudgetBytes);
+
+    /**
+     * @brief 设置字节预算，超出部分立即按 LRU 淘汰。
+     * @param budgetBytes 字节预算。
+     */
+    void setBudget(qint64 budgetBytes);
+
+    /** @brief 获取字节预算。 */
+    qint64 budget() const;
+
+    /** @brief 当前缓存占用的字节数。 */
+    qint64 usedBytes() const;
+
+    /**
+     * @brief 取出解码后的图片；未命中时解码 bytes 并放入缓存。
+     * @param key 数据项索引。
+     * @param bytes 原始压缩图片数据。
+     * @return 解码结果，失败时为空图片。
+     */
+    QImage image(int key, const QByteArray& bytes);
+
+    /**
+     * @brief 查找已缓存的图片，不触发解码。
+     * @param key 数据项索引。
+     * @return 命中时返回图片，否则为空图片。
+     */
+    QImage find(int key);
+
+    /**
+     * @brief 放入图片；单张超过预算时不缓存。
+     * @param key 数据项索引。
+     * @param image 解码后的图片。
+     */
+    void insert(int key, const QImage& image);
+
+    /** @brief 清空缓存。 */
+    void clear();
+
+private:
+    mutable QMutex m_mutex;
+    QCache<int, QImage> m_cache;
+};
+
+}  // namespace xlsxeditor
+}  // namespace fem
+}  // namespace neolux
+}  // namespace cc
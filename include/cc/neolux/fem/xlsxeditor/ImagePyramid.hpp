@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QImage>
+#include <QVector>
+
+namespace cc {
+namespace neolux {
+namespace fem {
+namespace xlsxeditor {
+
+/**
+ * @brief 缩略图的多级（逐级减半）金字塔。
+ *
+ * 第 0 级为最大缩略图，之后每级边长减半直到不小于最小边长。
+ * 缩放时选取不小于目标尺寸的最小层级，只需对少量像素做最终重采样，
+ * 代价与屏幕像素成正比，而与原图分辨率无关。
+ */
+class ImagePyramid {
+public:
+    /** @brief 默认最小层级边长。 */
+    static constexpr int kDefaultMinSide = 24;
+
+    ImagePyramid() = default;
+
+    /**
+     * @brief 由最大层级图片构建金字塔（可在工作线程中调用）。
+     * @param base 第 0 级图片。
+     * @param minSide 最小层级的最长边下限。
+     * @return 构建结果；base 为空时返回空金字塔。
+     */
+    static ImagePyramid build(const QImage& base, int minSide = kDefaultMinSide);
+
+    /** @brief 是否为空。 */
+    bool isNull() const { return m_levels.isEmpty(); }
+
+    /** @brief 层级数量。 */
+    int levelCount() const { return static_cast<int>(m_levels.size()); }
+
+    /** @brief 获取指定层级，0 为最大层级。 */
+    const QImage& level(int index) const { return m_levels[index]; }
+
+    /**
+     * @brief 选取最长边不小于 side 的最小层级；所有层级都更小时返回第 0 级。
+     * @param side 目标边长。
+     */
+    const QImage& levelFor(int side) const;
+
+    /**
+     * @brief 按 KeepAspectRatio 缩放到 side×side 方框内。
+     * @param side 目标边长。
+     * @return 缩放结果；金字塔为空时返回空图片。
+     */
+    QImage scaledTo(int side) const;
+
+    /** @brief 全部层级占用的字节数。 */
+    qint64 byteSize() const;
+
+private:
+    QVector<QImage> m_levels;
+};
+
+}  // namespace xlsxeditor
+}  // namespace fem
+}  // namespace neolux
+}  // namespace cc
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+namespace cc {
+namespace neolux {
+namespace fem {
+namespace xlsxeditor {
+
+/**
+ * @brief 工作簿旁的删除标记/描述编辑日志（追加写入的二进制文件）。
+ *
+ * 每次切换删除标记或修改描述时追加一条该数据项的完整状态并立即刷新，程序崩溃或关闭后
+ * 重新加载同一工作表与范围即可回放恢复。文件头记录工作簿内容指纹，工作簿内容变化后
+ * 旧日志自动作废；每条记录带长度与校验和，崩溃时写了一半的尾部记录在读取时被丢弃。
+ */
+class MarkJournal {
+public:
+    /** @brief 单个数据项的编辑状态（同一单元格以最后一条为准）。 */
+    struct Record {
+        int row;  // 1-based
+        int col;  // 1-based
+        bool deleted;
+        QString desc;
+    };
+
+    MarkJournal() = default;
+    MarkJournal(const MarkJournal&) = delete;
+    MarkJournal& operator=(const MarkJournal&) = delete;
+
+    /**
+     * @brief 计算日志文件路径：与工作簿同目录的隐藏文件，按工作表与范围区分。
+     * @param workbookPath 工作簿路径。
+     * @param scope 工作表与范围的规范化描述。
+     */
+    static QString pathFor(const QString& workbookPath, const QString& scope);
+
+    /**
+     * @brief 读取日志中的全部有效记录。
+     * @param path 日志文件路径。
+     * @param contentHash 当前工作簿内容指纹，与文件头不一致时视为无日志。
+     * @return 按写入顺序排列的记录；文件不存在、已作废或损坏时为空。
+     */
+    static QVector<Record> read(const QString& path, const QByteArray& contentHash);
+
+    /**
+     * @brief 以当前状态快照重写日志并开始记录。
+     *
+     * 重写同时完成压缩（去掉被覆盖的旧记录）与尾部修复；快照为空时删除旧文件，
+     * 直到第一次追加才创建新文件。
+     * @param path 日志文件路径。
+     * @param contentHash 工作簿内容指纹。
+     * @param snapshot 与源文件不同的数据项状态。
+     * @return 成功返回 true；失败时日志保持关闭，编辑不受影响。
+     */
+    bool start(const QString& path, const QByteArray& contentHash,
+               const QVector<Record>& snapshot);
+
+    /**
+     * @brief 追加一条记录并刷新到磁盘。
+     * @return 日志未开始或写入失败时返回 false。
+     */
+    bool append(const Record& record);
+
+    /** @brief 停止记录并关闭文件（不删除）。 */
+    void close();
+
+    /** @brief 是否正在记录。 */
+    bool isActive() const { return !m_path.isEmpty(); }
+
+private:
+    QString m_path;
+    QByteArray m_contentHash;
+    QFile m_file;
+
+    /** @brief 首次追加时创建文件并写入文件头。 */
+    bool ensureOpen();
+};
+
+}  // namespace xlsxeditor
+}  // namespace fem
+}  // namespace neolux
+}  // namespace cc
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <QRegularExpression>
+#include <QString>
+#include <QVector>
+#include <optional>
+#include <vector>
+
+#include "cc/neolux/fem/xlsxeditor/DataEntry.hpp"
+
+namespace cc {
+namespace neolux {
+namespace fem {
+namespace xlsxeditor {
+
+/**
+ * @brief 表头数值到 dose/focus 的映射。
+ *
+ * 横向列使用 dose，纵向行使用 focus；原表头中数值 0 对应中心点 center，其余按 step 递进
+ * （dose 递增、focus 递减）。
+ */
+struct AxisMapping {
+    bool enabled = false;
+    double doseCenter = 0.0;
+    double doseStep = 0.0;
+    double focusCenter = 0.0;
+    double focusStep = 0.0;
+
+    /** @brief 按 C locale 解析表头数值，非数值时为空。 */
+    static std::optional<double> headerNumber(const QString& headerText);
+
+    /** @brief 列表头对应的 dose，未启用或非数值时为空。 */
+    std::optional<double> dose(const QString& headerText) const;
+
+    /** @brief 行表头对应的 focus，未启用或非数值时为空。 */
+    std::optional<double> focus(const QString& headerText) const;
+};
+
+/**
+ * @brief 规则求值用的列式快照：每列一个数组，下标与数据项索引一致。
+ *
+ * 数值列中缺失的值（描述无数字、表头非数值或映射未启用）为 NaN。
+ */
+struct MarkColumns {
+    QVector<int> row;
+    QVector<int> col;
+    QVector<QString> desc;
+    QVector<double> value;  // 描述中的第一个数值
+    QVector<double> dose;
+    QVector<double> focus;
+
+    /** @brief 数据项数量。 */
+    int size() const { return static_cast<int>(row.size()); }
+
+    /** @brief 提取描述中的第一个数值，没有时为 NaN。 */
+    static double parseValue(const QString& text);
+};
+
+/**
+ * @brief 编译后的批量标记规则。
+ *
+ * 表达式由比较与 and/or/not（也可写作 &&、||、!）及括号组成，例如：
+ * @code
+ * desc ~ "NG" or value < 40 or value > 60
+ * (dose > 22.5 || focus < -0.1) && not desc == ""
+ * @endcode
+ * 字段：desc（字符串，支持 == != 与正则匹配 ~），value、dose、focus、row、col（数值，
+ * 支持 == != < <= > >=；col 也可与列字母字符串比较）。缺失数值参与的比较恒为假。
+ * 求值时每个比较对整列做一次紧凑循环，逻辑运算按掩码逐元素合并，不逐项解释表达式树。
+ */
+class MarkRule {
+public:
+    /**
+     * @brief 编译规则表达式。
+     * @param expression 规则文本。
+     * @param error 失败原因（输出，可为空）。
+     * @return 编译结果，语法或类型错误时为空。
+     */
+    static std::optional<MarkRule> compile(const QString& expression, QString* error = nullptr);
+
+    /** @brief 规则原文。 */
+    const QString& expression() const { return m_expression; }
+
+    /**
+     * @brief 对列式快照求值。
+     * @return 与数据项一一对应的掩码，命中为 1。
+     */
+    std::vector<char> evaluate(const MarkColumns& columns) const;
+
+private:
+    enum class Field { Desc, Value, Dose, Focus, Row, Col };
+    enum class Op { Eq, Ne, Lt, Le, Gt, Ge, Match };
+
+    struct Node {
+        enum class Kind { And, Or, Not, Compare };
+        Kind kind = Kind::Compare;
+        int left = -1;
+        int right = -1;
+        Field field = Field::Desc;
+        Op op = Op::Eq;
+        double number = 0.0;
+        QString text;
+        QRegularExpression regex;
+    };
+
+    class Parser;
+
+    QString m_expression;
+    std::vector<Node> m_nodes;
+    int m_root = -1;
+
+    std::vector<char> evaluateNode(int index, const MarkColumns& columns) const;
+
+    template <typename T>
+    static void compareColumn(const QVector<T>& column, Op op, double operand,
+                              std::vector<char>& mask);
+};
+
+}  // namespace xlsxeditor
+}  // namespace fem
+}  // namespace neolux
+}  // namespace cc
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <QtGlobal>
+
+namespace cc {
+namespace neolux {
+namespace fem {
+namespace xlsxeditor {
+
+/** @brief 编辑会话按类别统计的内存占用（字节）。 */
+struct MemoryUsage {
+    qint64 pictureBytes = 0;    // 常驻的压缩图片数据（DataEntry::bytes）
+    qint64 thumbnailBytes = 0;  // 网格缩略图金字塔
+    qint64 fullImageBytes = 0;  // 全分辨率解码缓存
+    qint64 cellBytes = 0;       // 描述与表头单元格
+    qint64 iconBytes = 0;       // 网格按当前缩放生成的图标（由视图报告）
+    qint64 previewBytes = 0;    // 悬停预览的原图与缩放结果（由视图报告）
+
+    /** @brief 各类别之和。 */
+    qint64 total() const {
+        return pictureBytes + thumbnailBytes + fullImageBytes + cellBytes + iconBytes +
+               previewBytes;
+    }
+};
+
+}  // namespace xlsxeditor
+}  // namespace fem
+}  // namespace neolux
+}  // namespace cc
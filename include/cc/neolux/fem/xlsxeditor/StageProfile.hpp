@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include "cc/neolux/fem/xlsxeditor/Tracer.hpp"
+
+namespace cc {
+namespace neolux {
+namespace fem {
+namespace xlsxeditor {
+
+/** @brief 一个阶段的累计耗时与工作量。 */
+struct StageTiming {
+    QString name;       // 阶段名，如 load.decode、save.write
+    qint64 nsecs = 0;   // 累计墙钟时间（并行阶段为各线程之和）
+    qint64 calls = 0;   // 计时次数
+    qint64 items = 0;   // 处理的项数（图片、单元格等）
+    qint64 bytes = 0;   // 处理的字节数
+};
+
+/**
+ * @brief 一次加载、显示或保存的分阶段计时记录。
+ *
+ * 同名阶段的多次计时累加到同一条记录，结果按首次出现的顺序排列。
+ * 所有接口均加锁，解码线程可并发写入。
+ */
+class StageProfile {
+public:
+    /** @brief 累加一次阶段计时。 */
+    void record(const QString& name, qint64 nsecs, qint64 items, qint64 bytes);
+
+    /** @brief 全部阶段的快照。 */
+    QVector<StageTiming> timings() const;
+
+private:
+    mutable QMutex m_mutex;
+    QVector<StageTiming> m_timings;
+};
+
+/**
+ * @brief 作用域计时器：析构（或 stop）时把耗时、项数与字节数记入 StageProfile。
+ *
+ * 开启跟踪（Tracer）时同时记录为一个跟踪段。profile 为空且未开启跟踪时不读取时钟也不加锁，
+ * 开销只有一次指针判断与一次原子读。
+ */
+class StageTimer {
+public:
+    StageTimer(StageProfile* profile, const char* name)
+        : m_profile(profile), m_name(name), m_traceStart(Tracer::isEnabled() ? Tracer::now() : -1) {
+        if (m_profile) {
+            m_timer.start();
+        }
+    }
+
+    ~StageTimer() { stop(); }
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+    /** @brief 累加本阶段处理的项数。 */
+    void addItems(qint64 items) { m_items += items; }
+
+    /** @brief 累加本阶段处理的字节数。 */
+    void addBytes(qint64 bytes) { m_bytes += bytes; }
+
+    /** @brief 提前结束计时并记录；之后的析构不再重复记录。 */
+    void stop() {
+        if (m_profile) {
+            m_profile->record(QLatin1String(m_name), m_timer.nsecsElapsed(), m_items, m_bytes);
+            m_profile = nullptr;
+        }
+        if (m_traceStart >= 0) {
+            Tracer::complete(m_name, m_traceStart, Tracer::now() - m_traceStart,
+                             QStringLiteral("items=%1 bytes=%2").arg(m_items).arg(m_bytes));
+            m_traceStart = -1;
+        }
+    }
+
+private:
+    StageProfile* m_profile;
+    const char* m_name;
+    qint64 m_traceStart;  // 未跟踪时为 -1
+    QElapsedTimer m_timer;
+    qint64 m_items = 0;
+    qint64 m_bytes = 0;
+};
+
+}  // namespace xlsxeditor
+}  // namespace fem
+}  // namespace neolux
+}  // namespace cc
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <QImage>
+#include <QSize>
+#include <QString>
+
+#include "cc/neolux/fem/xlsxeditor/ZipArchive.hpp"
+
+namespace cc {
+namespace neolux {
+namespace fem {
+namespace xlsxeditor {
+
+/**
+ * @brief 持久化的缩略图磁盘缓存。
+ *
+ * 每张图片的网格缩略图与原图尺寸存为一个文件，文件名由 ZIP 条目的 CRC32、尺寸与
+ * 缩略图边长构成：内容相同的图片跨工作簿共享，且无需读取或解压图片即可得到键值。
+ * 命中时刷新文件修改时间，trim 按修改时间做 LRU 淘汰直到总大小低于预算。
+ * 对象只保存目录与预算，可按值复制到工作线程；不同线程可并发读写（写入为原子替换）。
+ */
+class ThumbnailDiskCache {
+public:
+    /** @brief 默认预算：256 MB。 */
+    static constexpr qint64 kDefaultBudgetBytes = 256LL * 1024 * 1024;
+
+    /**
+     * @brief 构造缓存。
+     * @param directory 缓存目录，空串表示禁用。
+     * @param budgetBytes 字节预算，0 表示禁用。
+     */
+    explicit ThumbnailDiskCache(const QString& directory = defaultDirectory(),
+                                qint64 budgetBytes = kDefaultBudgetBytes);
+
+    /** @brief 默认缓存目录：QStandardPaths::CacheLocation 下的 thumbnails。 */
+    static QString defaultDirectory();
+
+    /** @brief 是否启用。 */
+    bool isEnabled() const { return !m_directory.isEmpty() && m_budget > 0; }
+
+    /** @brief 缓存目录。 */
+    const QString& directory() const { return m_directory; }
+
+    /** @brief 设置字节预算，0 表示禁用；超出部分在下次 trim 时淘汰。 */
+    void setBudget(qint64 budgetBytes) { m_budget = budgetBytes; }
+
+    /** @brief 获取字节预算。 */
+    qint64 budget() const { return m_budget; }
+
+    /**
+     * @brief 生成图片条目的缓存键。
+     * @param entry 图片所在的 ZIP 条目。
+     * @param side 缩略图边长。
+     */
+    static QString keyFor(const ZipArchive::Entry& entry, int side);
+
+    /**
+     * @brief 读取缓存的缩略图。
+     *
+     * 文件头与像素数据逐项校验：缩略图边长超过 side、大于原图或数据长度不符的文件视为未命中。
+     * @param key 缓存键。
+     * @param side 缩略图边长上限，与生成键时一致。
+     * @param imageSize 原图尺寸（输出）。
+     * @param thumbnail 缩略图（输出）。
+     * @return 命中返回 true。
+     */
+    bool load(const QString& key, int side, QSize& imageSize, QImage& thumbnail) const;
+
+    /**
+     * @brief 写入缩略图。
+     * @return 成功返回 true。
+     */
+    bool store(const QString& key, const QSize& imageSize, const QImage& thumbnail) const;
+
+    /** @brief 按最近最少使用淘汰，直到总大小不超过预算。 */
+    void trim() const;
+
+private:
+    QString m_directory;
+    qint64 m_budget;
+
+    QString filePath(const QString& key) const;
+
+    /** @brief 刷新文件修改时间，标记为最近使用。 */
+    static void touch(const QString& path);
+};
+
+}  // namespace xlsxeditor
+}  // namespace fem
+}  // namespace neolux
+}  // namespace cc
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QString>
+#include <atomic>
+
+namespace cc {
+namespace neolux {
+namespace fem {
+namespace xlsxeditor {
+
+/**
+ * @brief 进程级的事件跟踪：记录带线程号的时间段，导出为 Chrome trace JSON。
+ *
+ * 导出的文件可直接在 Perfetto（ui.perfetto.dev）或 chrome://tracing 中打开。
+ * 开启方式：
+ * - 环境变量 XLSXEDITOR_TRACE=<文件路径>：首个文档创建时开始记录，程序退出时写出；
+ * - 代码中调用 start()/stop()。
+ * 关闭时每个跟踪点只读取一次原子标志。
+ */
+class Tracer {
+public:
+    /** @brief 是否正在记录。 */
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    /** @brief 清空已记录的事件并开始记录。 */
+    static void start();
+
+    /**
+     * @brief 停止记录并把事件写出为 Chrome trace JSON。
+     * @param path 目标文件路径。
+     * @return 写出成功返回 true。
+     */
+    static bool stop(const QString& path);
+
+    /** @brief 若设置了环境变量 XLSXEDITOR_TRACE 则开始记录，并在程序退出时写出（只生效一次）。 */
+    static void startFromEnvironment();
+
+    /** @brief 跟踪时钟的当前时间（纳秒，自首次使用起）。 */
+    static qint64 now();
+
+    /**
+     * @brief 记录一个已结束的时间段（当前线程）。
+     * @param name 事件名，须为静态字符串。
+     * @param startNs 开始时间（now() 的取值）。
+     * @param durationNs 持续时间。
+     * @param detail 附加说明（如单元格、项数），为空时不输出。
+     */
+    static void complete(const char* name, qint64 startNs, qint64 durationNs,
+                         const QString& detail = QString());
+
+private:
+    static inline std::atomic<bool> s_enabled{false};
+};
+
+/**
+ * @brief 作用域跟踪段：构造时开始，析构时记录；未开启跟踪时不读取时钟。
+ */
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name, const QString& detail = QString())
+        : m_name(name), m_start(Tracer::isEnabled() ? Tracer::now() : -1) {
+        if (m_start >= 0) {
+            m_detail = detail;
+        }
+    }
+
+    ~TraceSpan() {
+        if (m_start >= 0) {
+            Tracer::complete(m_name, m_start, Tracer::now() - m_start, m_detail);
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* m_name;
+    qint64 m_start;
+    QString m_detail;
+};
+
+}  // namespace xlsxeditor
+}  // namespace fem
+}  // namespace neolux
+}  // namespace cc
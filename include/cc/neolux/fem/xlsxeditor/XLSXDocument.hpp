@@ -0,0 +1,477 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFuture>
+#include <QHash>
+#include <QImage>
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <memory>
+
+#include "cc/neolux/fem/xlsxeditor/CellTable.hpp"
+#include "cc/neolux/fem/xlsxeditor/DataEntry.hpp"
+#include "cc/neolux/fem/xlsxeditor/ImageCache.hpp"
+#include "cc/neolux/fem/xlsxeditor/MarkJournal.hpp"
+#include "cc/neolux/fem/xlsxeditor/MarkRule.hpp"
+#include "cc/neolux/fem/xlsxeditor/MemoryUsage.hpp"
+#include "cc/neolux/fem/xlsxeditor/StageProfile.hpp"
+#include "cc/neolux/fem/xlsxeditor/ThumbnailDiskCache.hpp"
+#include "cc/neolux/fem/xlsxeditor/XLSXPackage.hpp"
+
+namespace cc {
+namespace neolux {
+namespace fem {
+namespace xlsxeditor {
+
+struct LoadResult;
+struct DecodeQueue;
+
+/**
+ * @brief 一个工作表范围的编辑会话：加载、删除标记、描述编辑与保存。
+ *
+ * 不依赖 Qt Widgets，可在无显示环境（批处理、服务）中使用，多个文档可在不同线程中并行处理。
+ * 加载与保存均有两种形式：
+ * - loadAsync/saveAsync 立即返回，结果通过信号通知（需要事件循环，供界面使用）；
+ * - load/save 在调用线程中阻塞执行，不需要事件循环。
+ * 所有修改都经过本类的标记接口，以保持行/列计数、脏标记与编辑日志一致。
+ */
+class XLSXDocument : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造文档。
+     * @param parent 父对象。
+     * @param dryRun 是否使用假删除模式（true: 仅标记；false: 真删除）。
+     */
+    explicit XLSXDocument(QObject* parent = nullptr, bool dryRun = true);
+
+    /** @brief 析构时放弃在途加载，并等待在途保存结束。 */
+    ~XLSXDocument() override;
+
+    /**
+     * @brief 解析范围字符串为起止行列。
+     * @param range 范围文本，支持 A:C,1:10 或 A1:C10。
+     * @return 是否解析出有效范围。
+     */
+    static bool parseRange(const QString& range, int& startRow, int& startCol, int& endRow,
+                           int& endCol);
+
+    /** @brief 列字母转为 1-based 列号，见 CellRef.hpp。 */
+    static int columnNumber(const QString& col);
+
+    /** @brief 1-based 列号转为列字母，见 CellRef.hpp。 */
+    static QString columnName(int num);
+
+    /**
+     * @brief 在后台加载，立即返回；结果通过 loadFinished/loadFailed 通知。
+     *
+     * 在途加载会被直接放弃（发射 loadCanceled），随后发射 loadStarted 并清空当前数据。
+     * 布局在图片解码前就绪（layoutReady），图片随后逐批填入（picturesReady）；
+     * 期间可以标记与编辑，保存须等到 loadFinished。
+     */
+    void loadAsync(const QString& filePath, const QString& sheetName, const QString& range);
+
+    /**
+     * @brief 在调用线程中加载，阻塞至结束（图片解码仍并行），不需要事件循环。
+     *
+     * 与 loadAsync 发射相同的信号，但不发射 loadProgress；layoutReady 与 picturesReady
+     * 在解码全部结束后才依次发射。
+     * @return 成功返回 true；失败原因见 lastError。
+     */
+    bool load(const QString& filePath, const QString& sheetName, const QString& range);
+
+    /** @brief 放弃在途加载；无在途加载时不做任何事。 */
+    void cancelLoad();
+
+    /** @brief 是否有加载任务正在进行。 */
+    bool isLoading() const;
+
+    /**
+     * @brief 调整在途异步加载的解码顺序。
+     *
+     * 给定的数据项（通常是视口内及附近的单元格）按列出的顺序最先解码，其余按锚点顺序；
+     * 新的调用替换之前的列表，已开始解码的项不受影响。没有在途的异步加载时不做任何事。
+     * @param indices 数据项索引，按优先级从高到低排列。
+     */
+    void prioritizeDecode(const QVector<int>& indices);
+
+    /** @brief 最近一次加载或保存失败的原因。 */
+    const QString& lastError() const { return m_lastError; }
+
+    /** @brief 设置删除模式。 */
+    void setDryRun(bool dryRun) { m_dryRun = dryRun; }
+
+    /** @brief 是否为假删除模式。 */
+    bool isDryRun() const { return m_dryRun; }
+
+    /** @brief 设置全分辨率图片缓存的字节预算。 */
+    void setImageCacheBudget(qint64 budgetBytes);
+
+    /** @brief 获取全分辨率图片缓存的字节预算。 */
+    qint64 imageCacheBudget() const;
+
+    /**
+     * @brief 设置整个会话的内存预算，0 表示不限制（默认）。
+     *
+     * 超出预算时逐级降级：先压缩全分辨率缓存（为零时预览逐次解码、不保留），
+     * 再释放常驻的压缩图片数据（需要时从包中重新读取），最后收缩视图的图标缓存
+     * （iconCacheLimitChanged）；缩略图始终保留。预算只在数据变化时检查，查询不会触发降级。
+     */
+    void setMemoryBudget(qint64 budgetBytes);
+
+    /** @brief 获取内存预算，0 表示不限制。 */
+    qint64 memoryBudget() const { return m_memoryBudget; }
+
+    /**
+     * @brief 由视图报告其持有的图标与预览字节数，计入内存预算并检查预算。
+     * @param iconBytes 网格图标缓存。
+     * @param previewBytes 悬停预览。
+     */
+    void setViewMemory(qint64 iconBytes, qint64 previewBytes);
+
+    /** @brief 当前按类别统计的内存占用；只读查询，不检查预算。 */
+    MemoryUsage memoryUsage() const;
+
+    /** @brief 内存预算留给视图图标缓存的字节上限，-1 表示不限制。 */
+    qint64 iconCacheLimit() const { return m_iconLimit; }
+
+    /** @brief 设置缩略图磁盘缓存的字节预算，0 表示禁用，下次加载时生效。 */
+    void setThumbnailCacheBudget(qint64 budgetBytes);
+
+    /** @brief 获取缩略图磁盘缓存的字节预算。 */
+    qint64 thumbnailCacheBudget() const;
+
+    /** @brief 设置是否记录编辑日志（默认开启），下次加载时生效。 */
+    void setJournalEnabled(bool enabled) { m_journalEnabled = enabled; }
+
+    /** @brief 是否记录编辑日志。 */
+    bool isJournalEnabled() const { return m_journalEnabled; }
+
+    /**
+     * @brief 设置加载时是否解码图片（默认开启），下次加载时生效。
+     *
+     * 关闭时只读取图片锚点、描述与表头，不解码、不读写缩略图磁盘缓存；数据项保持 pending，
+     * 仍参与标记、规则、表头切换与保存，pictureAt 按需解码。供只需布局的批处理等调用方使用。
+     */
+    void setPictureDecodingEnabled(bool enabled) { m_decodePictures = enabled; }
+
+    /** @brief 加载时是否解码图片。 */
+    bool isPictureDecodingEnabled() const { return m_decodePictures; }
+
+    /**
+     * @brief 设置是否记录分阶段计时（默认关闭），下次加载或保存时生效。
+     *
+     * 开启后每次加载与保存结束时发射 stageTimingsReady；关闭时计时点只做一次空指针判断。
+     */
+    void setProfilingEnabled(bool enabled) { m_profilingEnabled = enabled; }
+
+    /** @brief 是否记录分阶段计时。 */
+    bool isProfilingEnabled() const { return m_profilingEnabled; }
+
+    /** @brief 最近一次记录了计时的加载的各阶段耗时（load.*、decode.*）。 */
+    const QVector<StageTiming>& lastLoadTimings() const { return m_loadTimings; }
+
+    /** @brief 最近一次记录了计时的保存的各阶段耗时（save.*）。 */
+    const QVector<StageTiming>& lastSaveTimings() const { return m_saveTimings; }
+
+    /** @brief 设置表头数值到 dose/focus 的映射，供显示与规则求值使用。 */
+    void setAxisMapping(const AxisMapping& mapping) { m_axisMapping = mapping; }
+
+    /** @brief 获取表头数值映射。 */
+    const AxisMapping& axisMapping() const { return m_axisMapping; }
+
+    /** @brief 当前文件路径。 */
+    const QString& filePath() const { return m_filePath; }
+
+    /** @brief 当前工作表名称。 */
+    const QString& sheetName() const { return m_sheetName; }
+
+    /** @brief 全部数据项（地址在下次加载前保持不变）。 */
+    const QVector<DataEntry>& entries() const { return m_data; }
+
+    /** @brief 已删除项数量。 */
+    int deletedCount() const { return m_deletedCount; }
+
+    /**
+     * @brief 按单元格查找数据项。
+     * @return 数据项索引，不存在时返回 -1。
+     */
+    int indexOf(int row, int col) const;
+
+    /**
+     * @brief 从加载时批量读取的单元格表中取文本（描述与表头）。
+     * @return 去除首尾空白的文本，不在已读取范围内时为空。
+     */
+    QString cellText(int row, int col) const;
+
+    /**
+     * @brief 获取指定单元格的全分辨率图片（经缓存按需解码）。
+     * @return 图片，不存在或解码失败时为空图片。
+     */
+    QImage pictureAt(int row, int col);
+
+    /**
+     * @brief 修改单个数据项的删除状态。
+     * @param index 数据项索引。
+     * @param deleted 目标状态。
+     */
+    void setDeleted(int index, bool deleted);
+
+    /**
+     * @brief 修改单个数据项的描述。
+     * @param index 数据项索引。
+     * @param text 新描述。
+     */
+    void setDescription(int index, const QString& text);
+
+    /**
+     * @brief 将全部数据项设为同一删除状态，结束后发射一次 entriesChanged。
+     * @param deleted 目标状态。
+     */
+    void setAllDeleted(bool deleted);
+
+    /**
+     * @brief 批量切换整行或整列的删除状态（全部保留时标记删除，否则全部恢复）。
+     *
+     * 结束后发射一次 entriesChanged。
+     * @param axis "row" 或 "col"。
+     * @param index 工作表行号/列号（1-based）。
+     */
+    void toggleAxis(const QString& axis, int index);
+
+    /**
+     * @brief 生成规则求值用的列式快照（描述、描述数值、dose/focus 与行列号）。
+     *
+     * 表头文本与映射结果按行/列各计算一次。
+     */
+    MarkColumns columns() const;
+
+    /**
+     * @brief 求出命中规则的数据项，只包括网格中的项（解码失败的项除外）。
+     * @return 命中的数据项索引（升序）。
+     */
+    QVector<int> matchRule(const MarkRule& rule) const;
+
+    /**
+     * @brief 将命中规则的数据项设为指定删除状态，结束后发射一次 entriesChanged。
+     * @param rule 已编译的规则。
+     * @param deleted 目标状态。
+     * @return 状态实际发生变化的数据项数。
+     */
+    int applyRule(const MarkRule& rule, bool deleted = true);
+
+    /**
+     * @brief 保存目标路径：源文件同级 filtered 目录下的同名文件（不创建目录）。
+     * @return 目标路径，未加载时为空。
+     */
+    QString saveTargetPath() const;
+
+    /** @brief 给定源文件的保存目标路径，规则同 saveTargetPath。 */
+    static QString saveTargetPathFor(const QString& sourcePath);
+
+    /**
+     * @brief 在后台保存，立即返回；进度与结果通过 saveProgress/saveFinished 通知。
+     *
+     * 发起时对编辑状态做快照，保存期间可继续编辑；保存进行中再次调用会合并为
+     * 结束后的一次保存。
+     * @return 成功发起（或已合并）返回 true；加载中、无数据或无法创建 filtered 目录时返回
+     *         false，原因见 lastError。
+     */
+    bool saveAsync();
+
+    /**
+     * @brief 在调用线程中保存，阻塞至结束，不需要事件循环。
+     *
+     * 发射 saveStarted/saveFinished，但不发射 saveProgress。
+     * @return 成功返回 true；加载中、保存中、无数据或保存失败时返回 false，原因见 lastError。
+     */
+    bool save();
+
+    /** @brief 是否有后台保存任务正在进行。 */
+    bool isSaving() const;
+
+    /** @brief 后台保存结束后是否还有一次被合并的保存要执行。 */
+    bool isSavePending() const { return m_savePending; }
+
+signals:
+    /**
+     * @brief 开始加载时发射。
+     *
+     * 发射时旧数据尚未清空，持有数据项指针的视图应在此释放引用。
+     */
+    void loadStarted(const QString& filePath);
+
+    /**
+     * @brief 图片解码进度变化时发射。
+     * @param value 已完成的图片数。
+     * @param maximum 范围内图片总数（尚未枚举完成时为 0）。
+     */
+    void loadProgress(int value, int maximum);
+
+    /**
+     * @brief 加载中布局就绪时发射：数据项、描述与表头已可用，图片仍在解码（pending）。
+     * @param itemCount 范围内的图片数。
+     */
+    void layoutReady(const QString& filePath, int itemCount);
+
+    /**
+     * @brief 一批图片解码完成并填入数据项时发射。
+     * @param indices 数据项索引；解码失败的项 pending 也已清除，但没有图片。
+     */
+    void picturesReady(const QVector<int>& indices);
+
+    /** @brief 加载成功后发射；解码失败的项此时已从行/列索引中移除。 */
+    void loadFinished(const QString& filePath, int itemCount);
+
+    /** @brief 加载失败时发射（被取消的加载不会发射）。 */
+    void loadFailed(const QString& filePath, const QString& message);
+
+    /** @brief 在途加载被放弃时发射。 */
+    void loadCanceled(const QString& filePath);
+
+    /**
+     * @brief 数据项的删除状态或描述变化时发射。
+     * @param index 数据项索引。
+     */
+    void entryChanged(int index);
+
+    /** @brief 批量修改删除状态后发射一次（代替逐项的 entryChanged）。 */
+    void entriesChanged();
+
+    /** @brief 开始保存时发射（被合并的保存重新发起时也会发射）。 */
+    void saveStarted(const QString& filePath);
+
+    /** @brief 后台保存进度变化时发射。 */
+    void saveProgress(int value, int maximum);
+
+    /** @brief 保存结束时发射；此时 isSavePending 为 true 表示随后还会再保存一次。 */
+    void saveFinished(const QString& filePath, bool ok);
+
+    /**
+     * @brief 内存预算留给视图图标缓存的上限变化时发射，视图应立即按此收缩缓存。
+     * @param limitBytes 字节上限，-1 表示不限制。
+     */
+    void iconCacheLimitChanged(qint64 limitBytes);
+
+    /**
+     * @brief 开启计时时，在 loadFinished/loadFailed/saveFinished 之前发射。
+     * @param operation "load" 或 "save"。
+     * @param timings 各阶段耗时，按首次出现的顺序排列。
+     */
+    void stageTimingsReady(const QString& operation, const QVector<StageTiming>& timings);
+
+private:
+    /** @brief 行/列二级索引：该行/列在网格中显示的数据项及其中已删除的数量。 */
+    struct AxisIndex {
+        QVector<int> entries;
+        int deletedCount = 0;
+    };
+
+    QString m_filePath;
+    QString m_sheetName;
+    QString m_range;
+    QString m_lastError;
+    bool m_dryRun;
+    bool m_journalEnabled;
+    bool m_decodePictures;
+    bool m_profilingEnabled;
+    QVector<DataEntry> m_data;
+    CellTable m_cells;                  // 加载时批量读取的描述与表头单元格
+    QHash<quint64, int> m_indexByCell;  // cellKey -> m_data 索引
+    QHash<int, AxisIndex> m_rowIndex;   // 工作表行号 -> 索引
+    QHash<int, AxisIndex> m_colIndex;   // 工作表列号 -> 索引
+    int m_deletedCount;
+    qint64 m_imageCacheBudget;  // 用户设置的全分辨率缓存预算，内存预算可能进一步压缩
+    qint64 m_memoryBudget;      // 0 表示不限制
+    qint64 m_pictureBytes;      // 常驻压缩数据之和
+    qint64 m_thumbnailBytes;
+    qint64 m_cellBytes;
+    qint64 m_iconBytes;         // 视图报告
+    qint64 m_previewBytes;      // 视图报告
+    qint64 m_iconLimit;         // 视图图标缓存上限，-1 表示不限制
+    AxisMapping m_axisMapping;
+    std::unique_ptr<XLSXPackage> m_package;  // 加载时打开的包，按需读取图片原始数据
+    ImageCache m_imageCache;
+    ThumbnailDiskCache m_thumbnailCache;
+    MarkJournal m_journal;
+    QFuture<std::shared_ptr<LoadResult>> m_loadFuture;
+    std::shared_ptr<DecodeQueue> m_decodeQueue;  // 在途异步加载的解码队列
+    /** @brief 加载代号，每次发起或取消加载时递增，用于丢弃过期结果。 */
+    quint64 m_loadGeneration;
+    QFuture<bool> m_saveFuture;
+    std::shared_ptr<StageProfile> m_loadProfile;  // 当前加载的计时，未开启时为空
+    std::shared_ptr<StageProfile> m_saveProfile;  // 当前保存的计时，未开启时为空
+    QVector<StageTiming> m_loadTimings;
+    QVector<StageTiming> m_saveTimings;
+    /** @brief 保存进行中又收到保存请求，结束后需以最新状态再保存一次。 */
+    bool m_savePending;
+    /** @brief 当前加载的跟踪起点，未跟踪时为 -1。 */
+    qint64 m_loadTraceStart;
+
+    static quint64 cellKey(int row, int col) { return CellTable::key(row, col); }
+
+    /** @brief 清空数据，记录新的文件、工作表与范围（调用前需已放弃在途加载）。 */
+    void reset(const QString& filePath, const QString& sheetName, const QString& range);
+
+    /** @brief 检查加载状态与数据能否保存，不能时记录 lastError。 */
+    bool checkCanSave();
+
+    /**
+     * @brief 计算保存目标路径并创建 filtered 目录。
+     * @return 目标路径，失败时为空并记录 lastError。
+     */
+    QString prepareSaveTargetPath();
+
+    /** @brief 接管加载中途的产出（布局或一批图片）；终结结果由 adoptLoadResult 处理。 */
+    void adoptPartialResult(const std::shared_ptr<LoadResult>& result);
+
+    /** @brief 接管布局：数据项与单元格，回放编辑日志并发射 layoutReady。 */
+    void adoptLayout(LoadResult& result);
+
+    /** @brief 把一批已解码的图片填入数据项并发射 picturesReady。 */
+    void adoptPictures(LoadResult& result);
+
+    /**
+     * @brief 接管加载的终结结果。
+     * @return 成功返回 true；失败时记录 lastError。
+     */
+    bool adoptLoadResult(const std::shared_ptr<LoadResult>& result);
+
+    /** @brief 取出计时快照并发射 stageTimingsReady；profile 为空时不做任何事。 */
+    void publishTimings(const QString& operation, const std::shared_ptr<StageProfile>& profile,
+                        QVector<StageTiming>& timings);
+
+    /** @brief 按内存预算调整全分辨率缓存，仍超出时释放常驻的压缩数据。 */
+    void enforceMemoryBudget();
+
+    /** @brief 更新视图图标缓存上限，变化时发射 iconCacheLimitChanged。 */
+    void setIconCacheLimit(qint64 limitBytes);
+
+    /** @brief 由 m_data 重建单元格索引与行/列二级索引。 */
+    void rebuildIndices();
+
+    /**
+     * @brief 修改删除状态并同步计数、脏标记与编辑日志，不发射信号。
+     * @return 状态是否发生变化。
+     */
+    bool updateDeleted(int index, bool deleted);
+
+    /** @brief 将数据项的当前状态追加到编辑日志。 */
+    void journalEntry(int index);
+
+    /** @brief 回放编辑日志，并以压缩后的状态重新开始记录。 */
+    void replayJournal(const QByteArray& contentHash);
+
+    /** @brief 以当前编辑状态快照发起后台保存。 */
+    bool startSave();
+
+    /** @brief 处理后台保存结束：记录错误、发射信号并执行被合并的保存请求。 */
+    void finishSave(const QString& targetPath, bool ok);
+};
+
+}  // namespace xlsxeditor
+}  // namespace fem
+}  // namespace neolux
+}  // namespace cc
@@ -1,17 +1,15 @@
 #pragma once
 
-#include <QHash>
 #include <QImage>
 #include <QLabel>
 #include <QPixmap>
 #include <QProgressBar>
-#include <QSet>
+#include <QSize>
 #include <QString>
 #include <QTimer>
-#include <QVector>
 #include <QWidget>
-#include <cc/neolux/utils/MiniXLSX/OpenXLSXWrapper.hpp>
-#include <cc/neolux/utils/MiniXLSX/XLPictureReader.hpp>
+
+#include "cc/neolux/fem/xlsxeditor/XLSXDocument.hpp"
 
 namespace Ui {
 class XLSXEditor;
@@ -22,24 +20,10 @@ namespace neolux {
 namespace fem {
 namespace xlsxeditor {
 
-/**
- * @brief 单个数据项（图片 + 描述）的内存表示。
- *
- * row/col 使用工作表中的 1-based 行列坐标。
- */
-struct DataEntry {
-    int row, col;
-    QImage image;
-    QString desc;
-    bool deleted;
-};
-
-class DataItem;
-
 /**
  * @brief XLSX 编辑器主界面组件。
  *
- * 负责加载指定工作表和范围内的数据项，并支持：
+ * 加载、标记与保存由内部的 XLSXDocument 完成，本组件只负责显示与交互：
  * - 预览已保留项
  * - 标记删除/取消删除
  * - 假删除保存（仅标红）与真删除保存（删除图片与描述）
@@ -56,10 +40,16 @@ public:
     explicit XLSXEditor(QWidget* parent = nullptr, bool dry_run = true);
 
     /**
-     * @brief 析构函数，释放 UI、XLSX 包装器与图片读取器资源。
+     * @brief 析构函数，释放 UI 资源（文档随组件析构，等待在途保存结束）。
      */
     ~XLSXEditor();
 
+    /**
+     * @brief 获取组件使用的文档（加载、标记与保存的实际执行者）。
+     * @return 文档对象，生命周期与组件相同。
+     */
+    XLSXDocument* document() const { return m_document; }
+
     /**
      * @brief 加载 XLSX 文件指定表和范围的数据。
      * @param filePath XLSX 文件路径。
@@ -68,6 +58,32 @@ public:
      */
     void loadXLSX(const QString& filePath, const QString& sheetName, const QString& range);
 
+    /**
+     * @brief 放弃当前正在进行的加载。
+     *
+     * 后台任务会在下一个检查点退出，其结果不会再写入编辑器；无在途加载时不做任何事。
+     */
+    void cancelLoad();
+
+    /**
+     * @brief 是否有加载任务正在进行。
+     * @return true 表示加载尚未结束。
+     */
+    bool isLoading() const;
+
+    /**
+     * @brief 设置加载模式。
+     * @param async true 时 loadXLSX 立即返回，结果通过 loadFinished/loadFailed 通知；
+     *        false 时 loadXLSX 阻塞至加载结束（默认）。
+     */
+    void setAsyncLoad(bool async);
+
+    /**
+     * @brief 获取当前加载模式。
+     * @return true 表示异步加载。
+     */
+    bool isAsyncLoad() const;
+
     /**
      * @brief 设置删除模式。
      * @param dry_run true 为假删除（标红），false 为真删除（删除图片与描述）。
@@ -89,120 +105,230 @@ public:
     void setAxisHeaderConfig(double doseCenter, double doseStep, double focusCenter,
                              double focusStep);
 
-private slots:
-    /** @brief 处理“保存”按钮点击事件。 */
-    void on_btnSave_clicked();
+    /**
+     * @brief 编译并应用批量标记规则，结束后整体刷新一次网格。
+     *
+     * 规则语法见 MarkRule，dose/focus 使用 setAxisHeaderConfig 的映射。
+     * @param expression 规则表达式，如 desc ~ "NG" or value > 60。
+     * @param deleted 命中项的目标删除状态。
+     * @param error 编译失败原因（输出，可为空）。
+     * @return 状态实际变化的数据项数；规则无效时返回 -1。
+     */
+    int applyMarkRule(const QString& expression, bool deleted = true, QString* error = nullptr);
 
-    /** @brief 处理“预览/显示全部”按钮点击事件。 */
-    void on_btnPreview_clicked();
+    /**
+     * @brief 设置全分辨率图片缓存的字节预算。
+     * @param budgetBytes 字节预算，超出时按最近最少使用淘汰。
+     */
+    void setImageCacheBudget(qint64 budgetBytes);
 
     /**
-     * @brief 处理“全选”复选框状态变化。
-     * @param state Qt 复选框状态值。
+     * @brief 获取全分辨率图片缓存的字节预算。
+     * @return 字节预算。
      */
-    void on_chkSelectAll_stateChanged(int state);
+    qint64 imageCacheBudget() const;
 
-protected:
     /**
-     * @brief 事件过滤器，用于处理滚轮缩放等交互。
-     * @param watched 事件源对象。
-     * @param event 事件对象。
-     * @return true 表示事件已处理，false 表示继续默认分发。
+     * @brief 设置整个会话的内存预算，超出时逐级释放全分辨率数据，缩略图始终保留。
+     * @param budgetBytes 字节预算，0 表示不限制。
      */
-    bool eventFilter(QObject* watched, QEvent* event) override;
+    void setMemoryBudget(qint64 budgetBytes);
 
-private:
-    Ui::XLSXEditor* ui;
-    QString m_filePath;
-    QString m_saveFilePath;
-    QString m_sheetName;
-    QString m_range;
-    QVector<DataEntry> m_data;  // 图片与描述及其位置
-    QVector<DataItem*> m_dataItems;
-    QVector<QWidget*> m_headerWidgets;
-    QHash<QString, int> m_indexByCell;
-    QHash<QString, DataItem*> m_itemByCell;
-    QSet<QString> m_dirtyCells;
-    cc::neolux::utils::MiniXLSX::OpenXLSXWrapper* m_wrapper;
-    cc::neolux::utils::MiniXLSX::XLPictureReader m_pictureReader;
-    int m_sheetIndex;
+    /**
+     * @brief 获取内存预算。
+     * @return 字节预算，0 表示不限制。
+     */
+    qint64 memoryBudget() const;
 
     /**
-     * @brief 解析范围字符串为起止行列。
-     * @param range 范围文本，支持 A:C,1:10 或 A1:C10。
-     * @param startRow 起始行（输出）。
-     * @param startCol 起始列（输出）。
-     * @param endRow 结束行（输出）。
-     * @param endCol 结束列（输出）。
+     * @brief 当前按类别统计的内存占用（含网格图标与悬停预览）。
+     * @return 各类别字节数。
      */
-    void parseRange(const QString& range, int& startRow, int& startCol, int& endRow, int& endCol);
+    MemoryUsage memoryUsage() const;
 
-    /** @brief 加载当前范围内的数据（无进度条版本）。 */
-    void loadData();
+    /**
+     * @brief 设置缩略图磁盘缓存的字节预算，下次加载时生效。
+     * @param budgetBytes 字节预算，0 表示禁用磁盘缓存；超出时按最近最少使用淘汰。
+     */
+    void setThumbnailCacheBudget(qint64 budgetBytes);
 
     /**
-     * @brief 加载当前范围内的数据，并更新进度条。
-     * @param progressBar 进度条对象引用。
+     * @brief 获取缩略图磁盘缓存的字节预算。
+     * @return 字节预算。
      */
-    void loadData(QProgressBar& progressBar);
+    qint64 thumbnailCacheBudget() const;
 
     /**
-     * @brief 将加载到的数据渲染到界面网格。
-     * @param previewOnly true 时仅显示未删除项。
+     * @brief 获取指定单元格的全分辨率图片（经缓存按需解码，可用于导出）。
+     * @param row 1-based 行号。
+     * @param col 1-based 列号。
+     * @return 图片，不存在或解码失败时为空图片。
      */
-    void displayData(bool previewOnly = false);
+    QImage pictureAt(int row, int col);
 
     /**
-     * @brief 保存当前编辑结果。
-     * @return 保存成功返回 true，否则返回 false。
+     * @brief 在后台保存当前编辑结果到源文件同级的 filtered 目录。
+     *
+     * 发起时对删除标记与描述做快照，整个保存流程在工作线程中完成，期间界面可继续编辑；
+     * 进度与结果通过 saveProgress/saveFinished 通知。保存进行中再次调用会合并为
+     * 结束后的一次保存。
+     * @return 成功发起（或已合并）返回 true；加载中或无数据时返回 false。
      */
-    bool saveData();
-    bool prepareSaveTargetFile();
+    bool saveXLSX();
 
     /**
-     * @brief 假删除保存：仅写回描述背景色标记。
-     * @return 保存成功返回 true，否则返回 false。
+     * @brief 是否有保存任务正在进行。
+     * @return true 表示保存尚未结束。
      */
-    bool saveFakeDelete();
+    bool isSaving() const;
 
     /**
-     * @brief 真删除保存：删除图片锚点、关系与描述内容。
-     * @return 保存成功返回 true，否则返回 false。
+     * @brief 设置是否记录加载、显示与保存的分阶段计时（默认关闭）。
+     *
+     * 开启后每个流程结束时发射 stageTimingsReady，也可通过 last*Timings 查询。
      */
-    bool saveRealDelete();
+    void setProfilingEnabled(bool enabled);
+
+    /** @brief 是否记录分阶段计时。 */
+    bool isProfilingEnabled() const;
+
+    /** @brief 最近一次加载的各阶段耗时。 */
+    const QVector<StageTiming>& lastLoadTimings() const;
+
+    /** @brief 最近一次网格构建的各阶段耗时（display.*）。 */
+    const QVector<StageTiming>& lastDisplayTimings() const { return m_displayTimings; }
+
+    /** @brief 最近一次保存的各阶段耗时。 */
+    const QVector<StageTiming>& lastSaveTimings() const;
 
     /**
-     * @brief 将列字母转换为列号。
-     * @param col 列字母（如 A、AB）。
-     * @return 1-based 列号。
+     * @brief 开始记录跟踪事件（进程级，所有编辑器与文档共享）。
+     *
+     * 也可设置环境变量 XLSXEDITOR_TRACE=<文件路径>，在首个文档创建时开始、程序退出时写出。
      */
-    int colToNum(const QString& col);
+    static void startTrace();
 
     /**
-     * @brief 将列号转换为列字母。
-     * @param num 1-based 列号。
-     * @return 列字母（如 A、AB）。
+     * @brief 停止记录并写出 Chrome trace JSON，可在 Perfetto 或 chrome://tracing 中打开。
+     * @param path 目标文件路径。
+     * @return 写出成功返回 true。
      */
-    QString numToCol(int num);
+    static bool stopTrace(const QString& path);
 
-    QString readCellText(int row, int col);
+signals:
+    /**
+     * @brief 开始加载时发射。
+     * @param filePath 正在加载的 XLSX 文件路径。
+     */
+    void loadStarted(const QString& filePath);
 
     /**
-     * @brief 生成单元格键值（row:col）。
-     * @param row 1-based 行号。
-     * @param col 1-based 列号。
-     * @return 用于哈希索引的字符串键。
+     * @brief 图片解码进度变化时发射。
+     * @param value 已完成的图片数。
+     * @param maximum 范围内图片总数（尚未枚举完成时为 0）。
      */
-    QString cellKey(int row, int col) const;
+    void loadProgress(int value, int maximum);
+
+    /**
+     * @brief 加载成功并完成界面构建后发射。
+     * @param filePath XLSX 文件路径。
+     * @param itemCount 加载到的数据项数量。
+     */
+    void loadFinished(const QString& filePath, int itemCount);
+
+    /**
+     * @brief 加载失败时发射（被取消的加载不会发射）。
+     * @param filePath XLSX 文件路径。
+     * @param message 失败原因。
+     */
+    void loadFailed(const QString& filePath, const QString& message);
+
+    /**
+     * @brief 保存进度变化时发射。
+     * @param value 已完成的步骤数。
+     * @param maximum 总步骤数。
+     */
+    void saveProgress(int value, int maximum);
+
+    /**
+     * @brief 保存结束时发射。
+     * @param filePath 保存目标路径。
+     * @param ok 是否保存成功。
+     */
+    void saveFinished(const QString& filePath, bool ok);
+
+    /**
+     * @brief 开启计时时，每次加载、网格构建或保存结束后发射。
+     * @param operation "load"、"display" 或 "save"。
+     * @param timings 各阶段耗时，按首次出现的顺序排列。
+     */
+    void stageTimingsReady(const QString& operation, const QVector<StageTiming>& timings);
+
+private slots:
+    /** @brief 处理“保存”按钮点击事件。 */
+    void on_btnSave_clicked();
+
+    /** @brief 处理“预览/显示全部”按钮点击事件。 */
+    void on_btnPreview_clicked();
+
+    /**
+     * @brief 处理“全选”复选框状态变化。
+     * @param state Qt 复选框状态值。
+     */
+    void on_chkSelectAll_stateChanged(int state);
+
+protected:
+    /**
+     * @brief 事件过滤器，用于处理滚轮缩放等交互。
+     * @param watched 事件源对象。
+     * @param event 事件对象。
+     * @return true 表示事件已处理，false 表示继续默认分发。
+     */
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+private:
+    Ui::XLSXEditor* ui;
+    /** @brief 加载、标记与保存的执行者，组件只做显示与交互。 */
+    XLSXDocument* m_document;
+    /** @brief 保存由“保存”按钮发起，结束时弹窗提示结果。 */
+    bool m_notifySaveResult;
+
+    /**
+     * @brief 将加载到的数据渲染到界面网格。
+     * @param previewOnly true 时仅显示未删除项。
+     */
+    void displayData(bool previewOnly = false);
+
+    /**
+     * @brief 处理加载失败：隐藏进度条，同步模式下弹窗提示。
+     * @param message 失败原因。
+     */
+    void handleLoadFailed(const QString& message);
+
+    /**
+     * @brief 处理保存结束：结束进度显示，由“保存”按钮发起时弹窗提示结果。
+     * @param targetPath 保存目标路径。
+     * @param ok 是否保存成功。
+     */
+    void handleSaveFinished(const QString& targetPath, bool ok);
 
     // 已移除：旧的点击弹窗预览接口，改为悬停预览。
 
-    /** @brief 清理并销毁当前界面中的 DataItem 组件。 */
+    /** @brief 清空数据项网格。 */
     void clearDataItems();
 
-    /** @brief 重置编辑器内部状态。 */
+    /** @brief 重置界面状态（网格、预览与缩放）。 */
     void resetState();
 
+    /** @brief 把网格图标与悬停预览占用的字节数报告给文档，计入内存预算并检查预算。 */
+    void reportViewMemory();
+
+    /** @brief 悬停预览的原图与缩放结果占用的字节数。 */
+    qint64 previewMemory() const;
+
+    /** @brief 加载中按当前视口调整解码顺序：视口内优先，附近次之。 */
+    void prioritizeVisibleDecode();
+
     /** @brief 根据当前缩放和范围更新滚动区内容尺寸。 */
     void updateScrollWidgetSize();
 
@@ -215,17 +341,8 @@ private:
     /** @brief 根据数据删除状态同步“全选”复选框状态。 */
     void syncSelectAllState();
 
-    /**
-     * @brief 开始保存进度显示。
-     * @param maximum 进度最大值。
-     */
-    void beginSaveProgress(int maximum);
-
-    /**
-     * @brief 更新保存进度值。
-     * @param value 当前进度值。
-     */
-    void updateSaveProgress(int value);
+    /** @brief 开始保存进度显示（加载进行中时不占用进度条）。 */
+    void beginSaveProgress();
 
     /** @brief 结束保存进度显示。 */
     void endSaveProgress();
@@ -237,16 +354,12 @@ private:
      */
     bool m_enableSaveProgress;
 
-    bool m_dryRun;
+    bool m_asyncLoad;
     bool m_previewOnly;
     double m_itemScale;
     bool m_syncingSelectAll;
-
-    bool m_axisHeaderConfigEnabled;
-    double m_doseCenter;
-    double m_doseStep;
-    double m_focusCenter;
-    double m_focusStep;
+    qsizetype m_gridEntryCount;  // 网格建立时占位的数据项数
+    QVector<StageTiming> m_displayTimings;
 
     // 悬停预览相关
     /** @brief 悬停预览窗格的指针（在主窗口内作为 tooltip 风格的 QLabel）。 */
@@ -266,11 +379,10 @@ private:
     QSize m_hoverPreviewStartSize;
     /** @brief 持久化保存的预览尺寸，重启后恢复该尺寸。 */
     QSize m_savedHoverPreviewSize; /**< persisted across restarts */
-    /** @brief 当前用于显示的原始 pixmap（用于缩放以保持质量）。 */
-    QPixmap m_hoverOrigPixmap;
+    /** @brief 当前预览的全分辨率图片（与缓存共享数据，用于缩放以保持质量）。 */
+    QImage m_hoverOrigImage;
 
     void showHoverPreview(int row, int col);
-    void hideHoverPreview(int row, int col);
 };
 
 }  // namespace xlsxeditor
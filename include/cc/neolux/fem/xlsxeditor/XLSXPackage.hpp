@@ -0,0 +1,246 @@
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cc/neolux/fem/xlsxeditor/CellTable.hpp"
+#include "cc/neolux/fem/xlsxeditor/ZipArchive.hpp"
+
+namespace pugi {
+class xml_document;
+}
+
+namespace cc {
+namespace neolux {
+namespace fem {
+namespace xlsxeditor {
+
+/**
+ * @brief 工作表中一张图片的锚点信息。
+ *
+ * rowNum/colNum 为锚点左上角所在单元格（1-based），与 XLPictureReader 的约定一致。
+ */
+struct PictureAnchor {
+    int rowNum;
+    int colNum;
+    std::string mediaPath;  // 归档内完整路径，如 xl/media/image1.png
+};
+
+/** @brief OPC 关系（.rels 中的一条 Relationship）。 */
+struct PackageRelationship {
+    std::string id;
+    std::string type;
+    std::string target;  // 已解析为归档内完整路径；外部关系保持原样
+    bool external;
+};
+
+/** @brief 单元格改写请求。 */
+struct CellEdit {
+    int row;  // 1-based
+    int col;  // 1-based
+    std::string text;       // 写入的文本（内联字符串），空串表示清空值
+    std::string fillColor;  // 背景色 ARGB（如 FFFF0000），空串表示去掉填充
+};
+
+/**
+ * @brief 直接基于 ZIP 中央目录访问 XLSX 包结构。
+ *
+ * 通过 workbook/sheet/drawing 的关系链定位工作表与图片，全部在内存中解析，
+ * 不解压到临时目录。
+ */
+class XLSXPackage {
+public:
+    /**
+     * @brief 打开 XLSX 文件并解析工作簿中的工作表列表。
+     * @param path XLSX 文件路径。
+     * @return 成功返回 true。
+     */
+    bool open(const std::string& path);
+
+    /** @brief 关闭文件。 */
+    void close();
+
+    /** @brief 是否已打开。 */
+    bool isOpen() const { return m_archive.isOpen(); }
+
+    /** @brief 底层 ZIP 归档。 */
+    const ZipArchive& archive() const { return m_archive; }
+
+    /** @brief 工作表数量。 */
+    int sheetCount() const { return static_cast<int>(m_sheets.size()); }
+
+    /**
+     * @brief 按工作簿中的顺序获取工作表名称。
+     * @param index 0-based 工作表索引。
+     */
+    std::string sheetName(int index) const;
+
+    /**
+     * @brief 按名称查找工作表索引。
+     * @return 0-based 索引，不存在时返回 -1。
+     */
+    int sheetIndex(const std::string& name) const;
+
+    /** @brief 工作表在 workbook.xml 中的 sheetId（calcChain 以此引用工作表），无效索引返回 0。 */
+    int sheetId(int sheetIndex) const;
+
+    /** @brief 工作簿部件路径（通常为 xl/workbook.xml）。 */
+    const std::string& workbookPath() const { return m_workbookPath; }
+
+    /** @brief 样式表部件路径（通常为 xl/styles.xml），没有样式表时返回空串。 */
+    std::string stylesPath() const;
+
+    /** @brief 计算链部件路径（通常为 xl/calcChain.xml），没有计算链时返回空串。 */
+    std::string calcChainPath() const;
+
+    /** @brief 工作表部件路径（如 xl/worksheets/sheet1.xml），无效索引返回空串。 */
+    std::string worksheetPath(int sheetIndex) const;
+
+    /** @brief 工作表关联的 drawing 部件路径，没有图片时返回空串。 */
+    std::string drawingPath(int sheetIndex) const;
+
+    /**
+     * @brief 枚举工作表中的图片锚点。
+     * @param sheetIndex 0-based 工作表索引。
+     * @return 按 drawing 中出现顺序排列的锚点列表。
+     */
+    std::vector<PictureAnchor> sheetPictures(int sheetIndex) const;
+
+    /**
+     * @brief 单次遍历工作表，批量读取若干区域内的单元格文本。
+     *
+     * 共享字符串表在首次调用时解析并缓存；数值、布尔与公式单元格取缓存值 <v> 原文，
+     * 富文本拼接全部文本段。
+     * @param sheetIndex 0-based 工作表索引。
+     * @param ranges 需要读取的区域，可重叠。
+     * @param table 输出表，落在任一区域内且有内容或非默认样式的单元格都会写入。
+     * @return 工作表部件读取失败时返回 false。
+     */
+    bool readCells(int sheetIndex, const std::vector<CellRange>& ranges, CellTable& table) const;
+
+    /**
+     * @brief 解析样式表，标记哪些 cellXfs 样式带有背景填充。
+     * @return 按 cellXfs 索引排列；没有样式表时为空。
+     */
+    std::vector<bool> filledStyles() const;
+
+    /**
+     * @brief 读取部件的关系列表。
+     * @param partPath 源部件路径；空串表示包根关系（_rels/.rels）。
+     */
+    std::vector<PackageRelationship> relationships(const std::string& partPath) const;
+
+    /**
+     * @brief 读取并解压部件内容。
+     * @return 成功返回 true。
+     */
+    bool readPart(const std::string& partPath, std::string& out) const;
+
+    /** @brief 部件对应的 .rels 路径，如 xl/worksheets/_rels/sheet1.xml.rels。 */
+    static std::string relsPathFor(const std::string& partPath);
+
+    /** @brief 将关系 Target 相对于源部件解析为归档内完整路径。 */
+    static std::string resolveTarget(const std::string& sourcePart, const std::string& target);
+
+private:
+    struct SheetInfo {
+        std::string name;
+        std::string path;
+        int sheetId;
+    };
+
+    ZipArchive m_archive;
+    std::string m_workbookPath;
+    std::vector<SheetInfo> m_sheets;
+    mutable std::vector<std::string> m_sharedStrings;
+    mutable bool m_sharedStringsLoaded = false;
+
+    /** @brief 共享字符串表（惰性解析）。 */
+    const std::vector<std::string>& sharedStrings() const;
+};
+
+/**
+ * @brief 基于已打开的 XLSXPackage 改写部件并一次性写出新包。
+ *
+ * 修改先暂存在内存中；write 时顺序遍历源归档：未改动的条目原样复制压缩数据，
+ * 被替换的部件重新压缩，被删除的部件直接省略，并同步移除 [Content_Types].xml
+ * 中对应的 Override。整个过程只读源文件一次、写目标文件一次，不解压到临时目录。
+ */
+class PackageRewriter {
+public:
+    /** @param package 源包，需在 write 完成前保持打开。 */
+    explicit PackageRewriter(const XLSXPackage& package) : m_package(package) {}
+
+    /** @brief 是否有待写出的改动。 */
+    bool isModified() const { return !m_replaced.empty() || !m_removed.empty(); }
+
+    /** @brief 以新内容替换部件。 */
+    void replacePart(const std::string& partPath, std::string content);
+
+    /** @brief 删除部件。 */
+    void removePart(const std::string& partPath);
+
+    /**
+     * @brief 读取部件的当前内容（已替换的取新内容）。
+     * @return 部件已删除或不存在时返回 false。
+     */
+    bool readPart(const std::string& partPath, std::string& out) const;
+
+    /**
+     * @brief 改写工作表中的单元格值与背景填充。
+     *
+     * 在工作表 XML 中按行列顺序定位或插入单元格；文本以内联字符串写入，不改动共享字符串表。
+     * 填充通过克隆单元格原有的 cellXfs 样式并替换 fillId 实现，字体、边框等其余格式保持不变，
+     * 相同的 (原样式, 颜色) 组合只克隆一次；只有确实要改动填充时才需要样式表。
+     * 覆盖公式单元格会去掉 <f>，并从 calcChain 中删除对应条目（链为空时删除整个部件）；
+     * 共享公式或数组公式的主单元格（带 ref 的 <f>）被其他单元格依赖，拒绝改写。
+     * @param sheetIndex 0-based 工作表索引。
+     * @param edits 改写请求。
+     * @return 工作表解析失败、需要填充但样式表缺失或无效、命中共享公式主单元格时返回 false，
+     *         此时不暂存任何改动。
+     */
+    bool writeCells(int sheetIndex, const std::vector<CellEdit>& edits);
+
+    /**
+     * @brief 删除工作表中锚定在指定单元格的图片。
+     *
+     * 改写 drawing 与其关系：只删除剩余锚点（含组合形状内部）已不再引用的关系，
+     * 并删除已不再被包内任何关系引用的图片部件。
+     * @param sheetIndex 0-based 工作表索引。
+     * @param cells 锚点左上角单元格 (row, col)，1-based，与 PictureAnchor 一致。
+     * @return drawing 或关系解析失败时返回 false；工作表没有图片时视为成功。
+     */
+    bool removePictures(int sheetIndex, const std::set<std::pair<int, int>>& cells);
+
+    /**
+     * @brief 写出新包。
+     * @param targetPath 目标路径，不能与源包相同。
+     * @return 成功返回 true；失败时不留下目标文件。
+     */
+    bool write(const std::string& targetPath) const;
+
+private:
+    const XLSXPackage& m_package;
+    std::map<std::string, std::string> m_replaced;
+    std::set<std::string> m_removed;
+
+    /** @brief 解析部件的当前内容。 */
+    bool loadPart(const std::string& partPath, pugi::xml_document& doc) const;
+
+    /**
+     * @brief 从 calcChain 中删除工作表内指定单元格的条目。
+     * @param cells 单元格 (row, col)，1-based。
+     */
+    bool removeCalcChainEntries(int sheetIndex, const std::set<std::pair<int, int>>& cells);
+
+    /** @brief 去掉 [Content_Types].xml 中已删除部件的 Override。 */
+    bool contentTypesWithoutRemoved(std::string& out) const;
+};
+
+}  // namespace xlsxeditor
+}  // namespace fem
+}  // namespace neolux
+}  // namespace cc
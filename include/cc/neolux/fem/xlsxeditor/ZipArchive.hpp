@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cc {
+namespace neolux {
+namespace fem {
+namespace xlsxeditor {
+
+/**
+ * @brief 只读 ZIP 归档访问器。
+ *
+ * 打开时仅解析一次中央目录建立条目索引，之后按需把单个条目解压到内存，
+ * 不产生任何临时文件。每次读取使用独立的文件句柄，可在多个线程中并发调用。
+ * 支持 stored/deflate 两种压缩方式与 Zip64 扩展。
+ */
+class ZipArchive {
+public:
+    /** @brief 中央目录中的单个条目。 */
+    struct Entry {
+        std::string name;
+        uint16_t versionMadeBy = 20;
+        uint16_t versionNeeded = 20;
+        uint16_t flags = 0;
+        uint16_t method = 0;
+        uint16_t modTime = 0;
+        uint16_t modDate = 0;
+        uint32_t crc32 = 0;
+        uint64_t compressedSize = 0;
+        uint64_t uncompressedSize = 0;
+        uint64_t localHeaderOffset = 0;
+        uint32_t externalAttributes = 0;
+    };
+
+    ZipArchive() = default;
+    ZipArchive(const ZipArchive&) = delete;
+    ZipArchive& operator=(const ZipArchive&) = delete;
+
+    /**
+     * @brief 打开归档并索引中央目录。
+     * @param path 归档文件路径。
+     * @return 成功返回 true。
+     */
+    bool open(const std::string& path);
+
+    /** @brief 关闭归档并清空索引。 */
+    void close();
+
+    /** @brief 是否已打开。 */
+    bool isOpen() const { return m_open; }
+
+    /** @brief 归档文件路径。 */
+    const std::string& path() const { return m_path; }
+
+    /** @brief 全部条目，顺序与中央目录一致。 */
+    const std::vector<Entry>& entries() const { return m_entries; }
+
+    /**
+     * @brief 按名称查找条目。
+     * @param name 归档内路径（如 xl/media/image1.png）。
+     * @return 条目指针，不存在时返回 nullptr。
+     */
+    const Entry* find(const std::string& name) const;
+
+    /**
+     * @brief 将条目解压到内存，并校验 CRC32。
+     *
+     * 声明的解压后尺寸超出压缩比上限或无法分配时返回 false，不抛出异常。
+     * @param name 归档内路径。
+     * @param out 解压后的内容（输出）。
+     * @return 成功返回 true。
+     */
+    bool read(const std::string& name, std::string& out) const;
+
+    /** @copydoc read(const std::string&, std::string&) const */
+    bool read(const Entry& entry, std::string& out) const;
+
+    /**
+     * @brief 读取条目未经解压的原始数据。
+     * @param entry 条目。
+     * @param out 压缩数据（输出）。
+     * @return 成功返回 true。
+     */
+    bool readRaw(const Entry& entry, std::string& out) const;
+
+    /**
+     * @brief 定位条目压缩数据在归档文件中的起始偏移（跳过本地头）。
+     * @param entry 条目。
+     * @param offset 数据起始偏移（输出）。
+     * @return 成功返回 true。
+     */
+    bool rawDataOffset(const Entry& entry, uint64_t& offset) const;
+
+    /**
+     * @brief 中央目录的原始字节。
+     *
+     * 中央目录包含每个条目的 CRC32 与尺寸，可作为整个包内容的廉价指纹。
+     */
+    const std::string& centralDirectory() const { return m_centralDirectory; }
+
+private:
+    bool m_open = false;
+    std::string m_path;
+    std::vector<Entry> m_entries;
+    std::unordered_map<std::string, size_t> m_indexByName;
+    std::string m_centralDirectory;
+};
+
+}  // namespace xlsxeditor
+}  // namespace fem
+}  // namespace neolux
+}  // namespace cc
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "cc/neolux/fem/xlsxeditor/ZipArchive.hpp"
+
+namespace cc {
+namespace neolux {
+namespace fem {
+namespace xlsxeditor {
+
+/**
+ * @brief 顺序写出的 ZIP 归档。
+ *
+ * 新条目以 deflate 压缩写入；来自其他归档的条目可原样复制压缩数据，
+ * 不经过解压与重新压缩。条目大小或偏移超出 32 位时自动使用 Zip64 扩展。
+ */
+class ZipWriter {
+public:
+    ZipWriter() = default;
+    ZipWriter(const ZipWriter&) = delete;
+    ZipWriter& operator=(const ZipWriter&) = delete;
+
+    /** @brief 析构时若尚未 finish，放弃写出并删除未完成的文件。 */
+    ~ZipWriter();
+
+    /**
+     * @brief 创建（覆盖）目标文件。
+     * @param path 目标路径。
+     * @return 成功返回 true。
+     */
+    bool open(const std::string& path);
+
+    /** @brief 是否已打开且尚未结束。 */
+    bool isOpen() const { return m_out.is_open(); }
+
+    /**
+     * @brief 以 deflate 压缩写入新条目，修改时间取当前时间。
+     * @param name 归档内路径。
+     * @param data 未压缩内容。
+     * @return 成功返回 true。
+     */
+    bool add(const std::string& name, const std::string& data);
+
+    /**
+     * @brief 原样复制源归档中条目的压缩数据（分块流式复制，不解压）。
+     * @param source 源归档。
+     * @param entry 源归档中的条目。
+     * @return 成功返回 true。
+     */
+    bool addRaw(const ZipArchive& source, const ZipArchive::Entry& entry);
+
+    /**
+     * @brief 写出中央目录并关闭文件。
+     * @return 成功返回 true；任一写入失败后返回 false。
+     */
+    bool finish();
+
+    /** @brief 放弃写出并删除未完成的文件。 */
+    void abort();
+
+private:
+    std::ofstream m_out;
+    std::string m_path;
+    std::vector<ZipArchive::Entry> m_entries;
+    uint64_t m_offset = 0;
+    bool m_failed = false;
+
+    bool writeLocalHeader(ZipArchive::Entry& entry);
+    bool writeBytes(const char* data, size_t size);
+};
+
+}  // namespace xlsxeditor
+}  // namespace fem
+}  // namespace neolux
+}  // namespace cc
@@ -0,0 +1,23 @@
+#include "cc/neolux/fem/xlsxeditor/CellRef.hpp"
+
+namespace cc::neolux::fem::xlsxeditor {
+
+int columnNumber(const QString& col) {
+    int num = 0;
+    for (QChar c : col.trimmed()) {
+        num = num * 26 + (c.toUpper().unicode() - 'A' + 1);
+    }
+    return num;
+}
+
+QString columnName(int num) {
+    QString col;
+    while (num > 0) {
+        num--;
+        col.prepend(QChar('A' + (num % 26)));
+        num /= 26;
+    }
+    return col;
+}
+
+}  // namespace cc::neolux::fem::xlsxeditor
@@ -0,0 +1,53 @@
+#include "cc/neolux/fem/xlsxeditor/CellTable.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace cc::neolux::fem::xlsxeditor {
+
+void CellTable::insert(int row, int col, std::string text, int styleIndex) {
+    const std::uint64_t cellKey = key(row, col);
+    if (m_cells.empty() || m_cells.back().key < cellKey) {
+        m_cells.push_back({cellKey, std::move(text), styleIndex});
+        return;
+    }
+    auto it = std::lower_bound(m_cells.begin(), m_cells.end(), cellKey,
+                               [](const Cell& cell, std::uint64_t k) { return cell.key < k; });
+    if (it != m_cells.end() && it->key == cellKey) {
+        it->text = std::move(text);
+        it->styleIndex = styleIndex;
+    } else {
+        m_cells.insert(it, {cellKey, std::move(text), styleIndex});
+    }
+}
+
+size_t CellTable::byteSize() const {
+    size_t bytes = m_cells.capacity() * sizeof(Cell);
+    for (const auto& cell : m_cells) {
+        // 短字符串存放在对象内部，容量不超过初始容量时没有额外分配。
+        if (cell.text.capacity() > std::string().capacity()) {
+            bytes += cell.text.capacity() + 1;
+        }
+    }
+    return bytes;
+}
+
+const std::string& CellTable::text(int row, int col) const {
+    static const std::string kEmpty;
+    const Cell* cell = find(row, col);
+    return cell ? cell->text : kEmpty;
+}
+
+int CellTable::styleIndex(int row, int col) const {
+    const Cell* cell = find(row, col);
+    return cell ? cell->styleIndex : 0;
+}
+
+const CellTable::Cell* CellTable::find(int row, int col) const {
+    const std::uint64_t cellKey = key(row, col);
+    auto it = std::lower_bound(m_cells.begin(), m_cells.end(), cellKey,
+                               [](const Cell& cell, std::uint64_t k) { return cell.key < k; });
+    return it != m_cells.end() && it->key == cellKey ? &*it : nullptr;
+}
+
+}  // namespace cc::neolux::fem::xlsxeditor
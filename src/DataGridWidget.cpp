@@ -0,0 +1,486 @@
+#include "cc/neolux/fem/xlsxeditor/DataGridWidget.hpp"
+
+#include <QCoreApplication>
+#include <QHash>
+#include <QHelpEvent>
+#include <QLineEdit>
+#include <QMenu>
+#include <QMouseEvent>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QToolTip>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "cc/neolux/fem/xlsxeditor/Tracer.hpp"
+
+namespace {
+constexpr int kBaseItemWidth = 70;
+constexpr int kBaseItemHeight = 90;
+constexpr int kBaseContentSize = 68;
+constexpr int kBaseIconSize = 66;
+constexpr int kBaseHeaderColWidth = 90;
+constexpr int kBaseHeaderRowHeight = 24;
+constexpr double kFocusInnerHeaderRatio = 0.65;
+constexpr double kInnerGapPercent = 0.3;
+constexpr qint64 kIconCacheBudgetBytes = 64LL * 1024 * 1024;
+
+int scaledLength(double base, double scale) {
+    return static_cast<int>(std::round(base * scale));
+}
+
+void paintAxisCorner(QPainter& painter, const QRect& rect, const QPalette& palette) {
+    painter.fillRect(rect, palette.window());
+    painter.setPen(palette.mid().color());
+    painter.drawRect(rect.adjusted(0, 0, -1, -1));
+    painter.setPen(palette.text().color());
+    painter.drawLine(rect.topLeft(), rect.bottomRight());
+    painter.drawText(QRect(rect.left() + 4, rect.top() + rect.height() / 2, rect.width() / 2 - 6,
+                           rect.height() / 2),
+                     Qt::AlignLeft | Qt::AlignBottom, "Focus");
+    painter.drawText(QRect(rect.left() + rect.width() / 2, rect.top() + 2, rect.width() / 2 - 4,
+                           rect.height() / 2 - 4),
+                     Qt::AlignRight | Qt::AlignTop, "Dose");
+}
+}  // namespace
+
+namespace cc::neolux::fem::xlsxeditor {
+
+DataGridWidget::DataGridWidget(QWidget* parent)
+    : QWidget(parent),
+      m_entries(nullptr),
+      m_twoLayerHeaders(false),
+      m_previewOnly(false),
+      m_scale(1.0),
+      m_metrics{},
+      m_basePointSize(9.0),
+      m_iconCache(kIconCacheBudgetBytes),
+      m_editor(nullptr),
+      m_editingIndex(-1) {
+    if (font().pointSizeF() > 0) {
+        m_basePointSize = font().pointSizeF();
+    }
+    // 修改值时复用同一个输入框，覆盖在对应描述区之上。
+    m_editor = new QLineEdit(this);
+    m_editor->hide();
+    connect(m_editor, &QLineEdit::editingFinished, this, &DataGridWidget::commitEdit);
+    updateMetrics();
+}
+
+void DataGridWidget::setGrid(const QVector<DataEntry>* entries, const QVector<Axis>& rows,
+                             const QVector<Axis>& cols, bool twoLayerHeaders) {
+    commitEdit();
+    m_entries = entries;
+    m_rows = rows;
+    m_cols = cols;
+    m_twoLayerHeaders = twoLayerHeaders;
+    m_cellAt.fill(-1, m_rows.size() * m_cols.size());
+    m_slotOfEntry.fill(-1, entries ? entries->size() : 0);
+
+    QHash<int, int> rowPos;
+    QHash<int, int> colPos;
+    for (int i = 0; i < m_rows.size(); ++i) {
+        rowPos.insert(m_rows[i].index, i);
+    }
+    for (int i = 0; i < m_cols.size(); ++i) {
+        colPos.insert(m_cols[i].index, i);
+    }
+    for (int i = 0; entries && i < entries->size(); ++i) {
+        const DataEntry& entry = (*entries)[i];
+        if (!entry.inGrid()) {
+            continue;
+        }
+        auto rowIt = rowPos.constFind(entry.row);
+        auto colIt = colPos.constFind(entry.col);
+        if (rowIt == rowPos.constEnd() || colIt == colPos.constEnd()) {
+            continue;
+        }
+        const int slot = rowIt.value() * static_cast<int>(m_cols.size()) + colIt.value();
+        m_cellAt[slot] = i;
+        m_slotOfEntry[i] = slot;
+    }
+
+    m_iconCache.clear();
+    updateMetrics();
+    update();
+}
+
+void DataGridWidget::clear() {
+    m_editingIndex = -1;
+    m_editor->hide();
+    m_entries = nullptr;
+    m_rows.clear();
+    m_cols.clear();
+    m_cellAt.clear();
+    m_slotOfEntry.clear();
+    m_iconCache.clear();
+    update();
+}
+
+void DataGridWidget::setIconCacheLimit(qint64 limitBytes) {
+    m_iconCache.setMaxCost(limitBytes < 0 ? kIconCacheBudgetBytes
+                                          : std::min(limitBytes, kIconCacheBudgetBytes));
+}
+
+void DataGridWidget::setItemScale(double scale) {
+    if (std::abs(scale - m_scale) < 1e-6) {
+        return;
+    }
+    commitEdit();
+    m_scale = scale;
+    m_iconCache.clear();
+    updateMetrics();
+    update();
+}
+
+void DataGridWidget::setPreviewOnly(bool previewOnly) {
+    if (previewOnly == m_previewOnly) {
+        return;
+    }
+    m_previewOnly = previewOnly;
+    update();
+}
+
+void DataGridWidget::refreshEntry(int index) {
+    const int slot = m_slotOfEntry.value(index, -1);
+    if (slot >= 0) {
+        update(cellRect(slot));
+    }
+}
+
+QVector<int> DataGridWidget::entriesIn(const QRect& rect) const {
+    QVector<int> indices;
+    if (!m_entries || m_rows.isEmpty() || m_cols.isEmpty()) {
+        return indices;
+    }
+    const Metrics& m = m_metrics;
+    const int firstCol = std::max(0, (rect.left() - m.bandW) / m.itemW);
+    const int lastCol =
+        std::min(static_cast<int>(m_cols.size()) - 1, (rect.right() - m.bandW) / m.itemW);
+    const int firstRow = std::max(0, (rect.top() - m.bandH) / m.itemH);
+    const int lastRow =
+        std::min(static_cast<int>(m_rows.size()) - 1, (rect.bottom() - m.bandH) / m.itemH);
+    for (int gridRow = firstRow; gridRow <= lastRow; ++gridRow) {
+        for (int gridCol = firstCol; gridCol <= lastCol; ++gridCol) {
+            const int index = m_cellAt[gridRow * static_cast<int>(m_cols.size()) + gridCol];
+            if (index >= 0 && isEntryVisible(index)) {
+                indices.append(index);
+            }
+        }
+    }
+    return indices;
+}
+
+QSize DataGridWidget::contentSize() const {
+    const Metrics& m = m_metrics;
+    return QSize(m.bandW + static_cast<int>(m_cols.size()) * m.itemW,
+                 m.bandH + static_cast<int>(m_rows.size()) * m.itemH);
+}
+
+QRect DataGridWidget::imageGlobalRect(int index) const {
+    const int slot = m_slotOfEntry.value(index, -1);
+    if (slot < 0) {
+        return QRect();
+    }
+    const QRect local = m_metrics.imageRect.translated(cellRect(slot).topLeft());
+    return QRect(mapToGlobal(local.topLeft()), local.size());
+}
+
+void DataGridWidget::updateMetrics() {
+    const double scale = std::clamp(m_scale, 0.5, 2.5);
+    const double gapRatio = std::clamp(kInnerGapPercent, 0.0, 20.0) / 100.0;
+    Metrics& m = m_metrics;
+    m.itemW = scaledLength(kBaseItemWidth, scale);
+    m.itemH = scaledLength(kBaseItemHeight, scale);
+    m.headerW = scaledLength(kBaseHeaderColWidth, scale);
+    m.headerH = scaledLength(kBaseHeaderRowHeight, scale);
+    m.innerHeaderW = m_twoLayerHeaders
+                         ? scaledLength(kBaseHeaderColWidth * kFocusInnerHeaderRatio, scale)
+                         : m.headerW;
+    m.bandW = m_twoLayerHeaders ? m.headerW + m.innerHeaderW : m.headerW;
+    m.bandH = (m_twoLayerHeaders ? 2 : 1) * m.headerH;
+    m.contentSize = scaledLength(kBaseContentSize, scale);
+    m.iconSize = scaledLength(kBaseIconSize, scale);
+    m.innerGap = std::max(1, static_cast<int>(std::round(m.itemW * gapRatio)));
+    m.imageRect = QRect(m.innerGap, m.innerGap, m.contentSize, m.contentSize);
+    m.textRect = QRect(m.innerGap, m.innerGap * 2 + m.contentSize, m.itemW - 2 * m.innerGap,
+                       std::max(14, m.itemH - m.contentSize - 3 * m.innerGap));
+}
+
+QFont DataGridWidget::itemFont() const {
+    QFont textFont = font();
+    textFont.setPointSizeF(std::max<qreal>(6.0, m_basePointSize * std::clamp(m_scale, 0.5, 2.5)));
+    return textFont;
+}
+
+QRect DataGridWidget::cellRect(int slot) const {
+    const int cols = std::max(1, static_cast<int>(m_cols.size()));
+    const Metrics& m = m_metrics;
+    return QRect(m.bandW + (slot % cols) * m.itemW, m.bandH + (slot / cols) * m.itemH, m.itemW,
+                 m.itemH);
+}
+
+bool DataGridWidget::isEntryVisible(int index) const {
+    return !m_previewOnly || !(*m_entries)[index].deleted;
+}
+
+DataGridWidget::Hit DataGridWidget::hitTest(const QPoint& pos) const {
+    const Metrics& m = m_metrics;
+    if (!m_entries || pos.x() < 0 || pos.y() < 0) {
+        return {Hit::None, -1};
+    }
+    if (pos.y() < m.bandH) {
+        const int gridCol = (pos.x() - m.bandW) / m.itemW;
+        if (pos.x() < m.bandW || gridCol >= m_cols.size()) {
+            return {Hit::None, -1};
+        }
+        return {Hit::ColHeader, m_cols[gridCol].index};
+    }
+
+    const int gridRow = (pos.y() - m.bandH) / m.itemH;
+    if (gridRow >= m_rows.size()) {
+        return {Hit::None, -1};
+    }
+    if (pos.x() < m.bandW) {
+        return {Hit::RowHeader, m_rows[gridRow].index};
+    }
+    const int gridCol = (pos.x() - m.bandW) / m.itemW;
+    if (gridCol >= m_cols.size()) {
+        return {Hit::None, -1};
+    }
+    const int slot = gridRow * static_cast<int>(m_cols.size()) + gridCol;
+    const int index = m_cellAt[slot];
+    if (index < 0 || !isEntryVisible(index)) {
+        return {Hit::None, -1};
+    }
+    const QPoint local = pos - cellRect(slot).topLeft();
+    if (m.imageRect.contains(local)) {
+        return {Hit::Image, index};
+    }
+    if (m.textRect.contains(local)) {
+        return {Hit::Description, index};
+    }
+    return {Hit::None, -1};
+}
+
+QPixmap DataGridWidget::iconFor(int index) const {
+    if (const QPixmap* cached = m_iconCache.object(index)) {
+        return *cached;
+    }
+    const TraceSpan span("grid.scaleIcon");
+    const QImage icon = (*m_entries)[index].thumbnails.scaledTo(m_metrics.iconSize);
+    if (icon.isNull()) {
+        return QPixmap();
+    }
+    const QPixmap pixmap = QPixmap::fromImage(icon);
+    m_iconCache.insert(index, new QPixmap(pixmap), icon.sizeInBytes());
+    return pixmap;
+}
+
+void DataGridWidget::paintEvent(QPaintEvent* event) {
+    const TraceSpan span("grid.paint");
+    QPainter painter(this);
+    const QRect dirty = event->rect();
+    paintHeaders(painter, dirty);
+    if (!m_entries || m_rows.isEmpty() || m_cols.isEmpty()) {
+        return;
+    }
+
+    // 只遍历与重绘区域相交的行列，代价与可见单元格数成正比。
+    const Metrics& m = m_metrics;
+    const int firstCol = std::max(0, (dirty.left() - m.bandW) / m.itemW);
+    const int lastCol =
+        std::min(static_cast<int>(m_cols.size()) - 1, (dirty.right() - m.bandW) / m.itemW);
+    const int firstRow = std::max(0, (dirty.top() - m.bandH) / m.itemH);
+    const int lastRow =
+        std::min(static_cast<int>(m_rows.size()) - 1, (dirty.bottom() - m.bandH) / m.itemH);
+
+    painter.setFont(itemFont());
+    for (int gridRow = firstRow; gridRow <= lastRow; ++gridRow) {
+        for (int gridCol = firstCol; gridCol <= lastCol; ++gridCol) {
+            const int slot = gridRow * static_cast<int>(m_cols.size()) + gridCol;
+            const int index = m_cellAt[slot];
+            if (index >= 0 && isEntryVisible(index)) {
+                paintCell(painter, slot, index);
+            }
+        }
+    }
+}
+
+void DataGridWidget::paintCell(QPainter& painter, int slot, int index) const {
+    const Metrics& m = m_metrics;
+    const DataEntry& entry = (*m_entries)[index];
+    const QRect cell = cellRect(slot);
+
+    painter.setPen(QColor("#606060"));
+    painter.setBrush(Qt::NoBrush);
+    painter.drawRect(cell.adjusted(0, 0, -1, -1));
+
+    const QRect imageRect = m.imageRect.translated(cell.topLeft());
+    const QPixmap icon = iconFor(index);
+    if (!icon.isNull()) {
+        painter.drawPixmap(imageRect.x() + (imageRect.width() - icon.width()) / 2,
+                           imageRect.y() + (imageRect.height() - icon.height()) / 2, icon);
+    } else if (entry.pending) {
+        // 图片仍在解码：占位框，解码完成后由 refreshEntry 重绘。
+        painter.fillRect(imageRect, palette().alternateBase());
+        painter.setPen(palette().placeholderText().color());
+        painter.drawText(imageRect, Qt::AlignCenter, QStringLiteral("…"));
+    }
+
+    const QRect textRect = m.textRect.translated(cell.topLeft());
+    painter.fillRect(textRect, entry.deleted ? QColor("#ff4d4f") : palette().base().color());
+    painter.setPen(palette().mid().color());
+    painter.drawRect(textRect.adjusted(0, 0, -1, -1));
+    const QRect textArea = textRect.adjusted(2, 0, -2, 0);
+    painter.setPen(palette().text().color());
+    painter.drawText(textArea, Qt::AlignLeft | Qt::AlignVCenter,
+                     painter.fontMetrics().elidedText(entry.desc, Qt::ElideRight,
+                                                      textArea.width()));
+}
+
+void DataGridWidget::paintHeaders(QPainter& painter, const QRect& dirty) const {
+    const Metrics& m = m_metrics;
+    if (m_twoLayerHeaders && dirty.intersects(QRect(0, 0, m.bandW, m.bandH))) {
+        paintAxisCorner(painter, QRect(0, 0, m.bandW, m.bandH), palette());
+    }
+
+    const int flags = Qt::AlignCenter | Qt::TextWordWrap;
+    painter.setPen(palette().windowText().color());
+    for (int i = 0; i < m_cols.size(); ++i) {
+        const QRect outer(m.bandW + i * m.itemW, 0, m.itemW, m.headerH);
+        if (outer.left() > dirty.right() || outer.right() < dirty.left()) {
+            continue;
+        }
+        painter.drawText(outer, flags, m_cols[i].outer);
+        if (m_twoLayerHeaders) {
+            painter.drawText(outer.translated(0, m.headerH), flags, m_cols[i].inner);
+        }
+    }
+    for (int i = 0; i < m_rows.size(); ++i) {
+        const QRect outer(0, m.bandH + i * m.itemH, m.headerW, m.itemH);
+        if (outer.top() > dirty.bottom() || outer.bottom() < dirty.top()) {
+            continue;
+        }
+        painter.drawText(outer, flags, m_rows[i].outer);
+        if (m_twoLayerHeaders) {
+            painter.drawText(QRect(m.headerW, outer.top(), m.innerHeaderW, m.itemH), flags,
+                             m_rows[i].inner);
+        }
+    }
+}
+
+void DataGridWidget::mousePressEvent(QMouseEvent* event) {
+    const Hit hit = hitTest(event->position().toPoint());
+    if (event->button() == Qt::MiddleButton && hit.kind == Hit::Image) {
+        const DataEntry& entry = (*m_entries)[hit.index];
+        emit imagePreviewRequested(entry.row, entry.col);
+        event->accept();
+        return;
+    }
+    if (event->button() == Qt::RightButton && hit.kind == Hit::Description) {
+        showContextMenu(hit.index, event->globalPosition().toPoint());
+        event->accept();
+        return;
+    }
+    QWidget::mousePressEvent(event);
+}
+
+void DataGridWidget::mouseDoubleClickEvent(QMouseEvent* event) {
+    const Hit hit = hitTest(event->position().toPoint());
+    switch (hit.kind) {
+        case Hit::Description:
+            emit toggleRequested(hit.index);
+            break;
+        case Hit::RowHeader:
+            emit headerDoubleClicked(QStringLiteral("row"), hit.index);
+            break;
+        case Hit::ColHeader:
+            emit headerDoubleClicked(QStringLiteral("col"), hit.index);
+            break;
+        default:
+            QWidget::mouseDoubleClickEvent(event);
+            return;
+    }
+    event->accept();
+}
+
+bool DataGridWidget::event(QEvent* event) {
+    if (event->type() == QEvent::ToolTip) {
+        auto* helpEvent = static_cast<QHelpEvent*>(event);
+        QString tip;
+        switch (hitTest(helpEvent->pos()).kind) {
+            case Hit::Description:
+                tip = QCoreApplication::translate("DataItem", "Double-click to keep/remove");
+                break;
+            case Hit::RowHeader:
+                tip = QCoreApplication::translate("XLSXEditor", "Double-click to toggle this row");
+                break;
+            case Hit::ColHeader:
+                tip =
+                    QCoreApplication::translate("XLSXEditor", "Double-click to toggle this column");
+                break;
+            default:
+                break;
+        }
+        if (tip.isEmpty()) {
+            QToolTip::hideText();
+            event->ignore();
+        } else {
+            QToolTip::showText(helpEvent->globalPos(), tip, this);
+        }
+        return true;
+    }
+    return QWidget::event(event);
+}
+
+void DataGridWidget::showContextMenu(int index, const QPoint& globalPos) {
+    QMenu menu(this);
+    QAction* markAction =
+        menu.addAction((*m_entries)[index].deleted
+                           ? QCoreApplication::translate("DataItem", "Unmark")
+                           : QCoreApplication::translate("DataItem", "Mark"));
+    QAction* editAction = menu.addAction(QCoreApplication::translate("DataItem", "Modify Value"));
+    QAction* chosen = menu.exec(globalPos);
+    // 菜单期间网格可能被重建，索引失效时放弃操作。
+    if (m_slotOfEntry.value(index, -1) < 0) {
+        return;
+    }
+    if (chosen == markAction) {
+        emit toggleRequested(index);
+    } else if (chosen == editAction) {
+        beginEdit(index);
+    }
+}
+
+void DataGridWidget::beginEdit(int index) {
+    commitEdit();
+    const int slot = m_slotOfEntry.value(index, -1);
+    if (slot < 0) {
+        return;
+    }
+    m_editingIndex = index;
+    m_editor->setFont(itemFont());
+    m_editor->setGeometry(m_metrics.textRect.translated(cellRect(slot).topLeft()));
+    m_editor->setText((*m_entries)[index].desc);
+    m_editor->show();
+    m_editor->setFocus(Qt::MouseFocusReason);
+    m_editor->selectAll();
+}
+
+void DataGridWidget::commitEdit() {
+    if (m_editingIndex < 0) {
+        return;
+    }
+    // 先复位索引：隐藏输入框引起的失焦会再次触发 editingFinished。
+    const int index = std::exchange(m_editingIndex, -1);
+    const QString text = m_editor->text();
+    m_editor->hide();
+    if (m_entries && index < m_entries->size() && text != (*m_entries)[index].desc) {
+        emit descriptionEdited(index, text);
+    }
+    refreshEntry(index);
+}
+
+}  // namespace cc::neolux::fem::xlsxeditor
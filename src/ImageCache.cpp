@@ -0,0 +1,57 @@
+#include "cc/neolux/fem/xlsxeditor/ImageCache.hpp"
+
+#include <QMutexLocker>
+
+namespace cc::neolux::fem::xlsxeditor {
+
+ImageCache::ImageCache(qint64 budgetBytes) : m_cache(budgetBytes) {}
+
+void ImageCache::setBudget(qint64 budgetBytes) {
+    QMutexLocker locker(&m_mutex);
+    m_cache.setMaxCost(budgetBytes);
+}
+
+qint64 ImageCache::budget() const {
+    QMutexLocker locker(&m_mutex);
+    return m_cache.maxCost();
+}
+
+qint64 ImageCache::usedBytes() const {
+    QMutexLocker locker(&m_mutex);
+    return m_cache.totalCost();
+}
+
+QImage ImageCache::image(int key, const QByteArray& bytes) {
+    QImage cached = find(key);
+    if (!cached.isNull() || bytes.isEmpty()) {
+        return cached;
+    }
+
+    // 解码在锁外进行，避免并发取图时互相阻塞。
+    const QImage decoded = QImage::fromData(bytes);
+    if (!decoded.isNull()) {
+        insert(key, decoded);
+    }
+    return decoded;
+}
+
+QImage ImageCache::find(int key) {
+    QMutexLocker locker(&m_mutex);
+    const QImage* cached = m_cache.object(key);
+    return cached ? *cached : QImage();
+}
+
+void ImageCache::insert(int key, const QImage& image) {
+    if (image.isNull()) {
+        return;
+    }
+    QMutexLocker locker(&m_mutex);
+    m_cache.insert(key, new QImage(image), image.sizeInBytes());
+}
+
+void ImageCache::clear() {
+    QMutexLocker locker(&m_mutex);
+    m_cache.clear();
+}
+
+}  // namespace cc::neolux::fem::xlsxeditor
@@ -0,0 +1,57 @@
+#include "cc/neolux/fem/xlsxeditor/ImagePyramid.hpp"
+
+#include <algorithm>
+
+namespace {
+int longSide(const QImage& image) {
+    return std::max(image.width(), image.height());
+}
+}  // namespace
+
+namespace cc::neolux::fem::xlsxeditor {
+
+ImagePyramid ImagePyramid::build(const QImage& base, int minSide) {
+    ImagePyramid pyramid;
+    if (base.isNull()) {
+        return pyramid;
+    }
+
+    QImage level = base;
+    pyramid.m_levels.append(level);
+    while (longSide(level) / 2 >= minSide) {
+        level = level.scaled(std::max(1, level.width() / 2), std::max(1, level.height() / 2),
+                             Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        pyramid.m_levels.append(level);
+    }
+    return pyramid;
+}
+
+const QImage& ImagePyramid::levelFor(int side) const {
+    for (int i = levelCount() - 1; i > 0; --i) {
+        if (longSide(m_levels[i]) >= side) {
+            return m_levels[i];
+        }
+    }
+    return m_levels.first();
+}
+
+QImage ImagePyramid::scaledTo(int side) const {
+    if (isNull() || side <= 0) {
+        return QImage();
+    }
+    const QImage& source = levelFor(side);
+    if (longSide(source) == side) {
+        return source;
+    }
+    return source.scaled(side, side, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+}
+
+qint64 ImagePyramid::byteSize() const {
+    qint64 total = 0;
+    for (const auto& level : m_levels) {
+        total += level.sizeInBytes();
+    }
+    return total;
+}
+
+}  // namespace cc::neolux::fem::xlsxeditor
@@ -0,0 +1,170 @@
+#include "cc/neolux/fem/xlsxeditor/MarkJournal.hpp"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+
+namespace {
+constexpr quint32 kMagic = 0x4A4D4558;  // "XEMJ"
+constexpr quint16 kVersion = 1;
+constexpr auto kStreamVersion = QDataStream::Qt_6_0;
+
+/** @brief 文件头：魔数、版本与工作簿内容指纹。 */
+QByteArray encodeHeader(const QByteArray& contentHash) {
+    QByteArray header;
+    QDataStream out(&header, QIODevice::WriteOnly);
+    out.setVersion(kStreamVersion);
+    out << kMagic << kVersion << contentHash;
+    return header;
+}
+
+/** @brief 单条记录帧：负载长度、负载与校验和。 */
+QByteArray encodeRecord(const cc::neolux::fem::xlsxeditor::MarkJournal::Record& record) {
+    QByteArray payload;
+    QDataStream payloadOut(&payload, QIODevice::WriteOnly);
+    payloadOut.setVersion(kStreamVersion);
+    payloadOut << qint32(record.row) << qint32(record.col) << record.deleted << record.desc;
+
+    QByteArray frame;
+    QDataStream out(&frame, QIODevice::WriteOnly);
+    out.setVersion(kStreamVersion);
+    out << quint32(payload.size());
+    out.writeRawData(payload.constData(), static_cast<int>(payload.size()));
+    out << qChecksum(payload);
+    return frame;
+}
+}  // namespace
+
+namespace cc::neolux::fem::xlsxeditor {
+
+QString MarkJournal::pathFor(const QString& workbookPath, const QString& scope) {
+    const QFileInfo info(workbookPath);
+    const QByteArray scopeHash =
+        QCryptographicHash::hash(scope.toUtf8(), QCryptographicHash::Sha1).toHex().left(8);
+    return info.absoluteDir().filePath(
+        QStringLiteral(".%1.%2.marks").arg(info.fileName(), QString::fromLatin1(scopeHash)));
+}
+
+QVector<MarkJournal::Record> MarkJournal::read(const QString& path,
+                                               const QByteArray& contentHash) {
+    QVector<Record> records;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return records;
+    }
+    const QByteArray bytes = file.readAll();
+
+    QDataStream in(bytes);
+    in.setVersion(kStreamVersion);
+    quint32 magic = 0;
+    quint16 version = 0;
+    QByteArray hash;
+    in >> magic >> version >> hash;
+    if (in.status() != QDataStream::Ok || magic != kMagic || version != kVersion ||
+        hash != contentHash) {
+        return records;
+    }
+
+    // 逐帧读取，遇到不完整或校验失败的帧即停止（崩溃时写了一半的尾部记录）。
+    while (!in.atEnd()) {
+        quint32 size = 0;
+        in >> size;
+        if (in.status() != QDataStream::Ok || size > static_cast<quint32>(bytes.size())) {
+            break;
+        }
+        QByteArray payload(static_cast<qsizetype>(size), Qt::Uninitialized);
+        quint16 checksum = 0;
+        if (in.readRawData(payload.data(), static_cast<int>(size)) != static_cast<int>(size)) {
+            break;
+        }
+        in >> checksum;
+        if (in.status() != QDataStream::Ok || checksum != qChecksum(payload)) {
+            break;
+        }
+
+        QDataStream payloadIn(payload);
+        payloadIn.setVersion(kStreamVersion);
+        qint32 row = 0;
+        qint32 col = 0;
+        Record record{0, 0, false, QString()};
+        payloadIn >> row >> col >> record.deleted >> record.desc;
+        if (payloadIn.status() != QDataStream::Ok) {
+            break;
+        }
+        record.row = row;
+        record.col = col;
+        records.append(record);
+    }
+    return records;
+}
+
+bool MarkJournal::start(const QString& path, const QByteArray& contentHash,
+                        const QVector<Record>& snapshot) {
+    close();
+    if (snapshot.isEmpty()) {
+        QFile::remove(path);
+    } else {
+        // 先完整写出再替换，重写途中崩溃不会丢失旧日志。
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) {
+            qWarning() << "Failed to create mark journal:" << path;
+            return false;
+        }
+        file.write(encodeHeader(contentHash));
+        for (const auto& record : snapshot) {
+            file.write(encodeRecord(record));
+        }
+        if (!file.commit()) {
+            qWarning() << "Failed to write mark journal:" << path;
+            return false;
+        }
+    }
+    m_path = path;
+    m_contentHash = contentHash;
+    return true;
+}
+
+bool MarkJournal::append(const Record& record) {
+    if (!ensureOpen()) {
+        return false;
+    }
+    const QByteArray frame = encodeRecord(record);
+    if (m_file.write(frame) != frame.size() || !m_file.flush()) {
+        qWarning() << "Failed to append to mark journal:" << m_path;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MarkJournal::close() {
+    m_file.close();
+    m_path.clear();
+    m_contentHash.clear();
+}
+
+bool MarkJournal::ensureOpen() {
+    if (m_path.isEmpty()) {
+        return false;
+    }
+    if (m_file.isOpen()) {
+        return true;
+    }
+    m_file.setFileName(m_path);
+    const bool exists = m_file.exists();
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "Failed to open mark journal:" << m_path;
+        close();
+        return false;
+    }
+    if (!exists && m_file.write(encodeHeader(m_contentHash)) < 0) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+}  // namespace cc::neolux::fem::xlsxeditor
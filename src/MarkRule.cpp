@@ -0,0 +1,433 @@
+#include "cc/neolux/fem/xlsxeditor/MarkRule.hpp"
+
+#include <QLocale>
+#include <cmath>
+#include <limits>
+
+#include "cc/neolux/fem/xlsxeditor/CellRef.hpp"
+
+namespace {
+constexpr double kMissing = std::numeric_limits<double>::quiet_NaN();
+}  // namespace
+
+namespace cc::neolux::fem::xlsxeditor {
+
+std::optional<double> AxisMapping::headerNumber(const QString& headerText) {
+    const QString text = headerText.trimmed();
+    if (text.isEmpty()) {
+        return std::nullopt;
+    }
+    bool ok = false;
+    const double value = QLocale::c().toDouble(text, &ok);
+    if (!ok) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+std::optional<double> AxisMapping::dose(const QString& headerText) const {
+    const std::optional<double> number = enabled ? headerNumber(headerText) : std::nullopt;
+    if (!number) {
+        return std::nullopt;
+    }
+    return doseCenter + *number * doseStep;
+}
+
+std::optional<double> AxisMapping::focus(const QString& headerText) const {
+    const std::optional<double> number = enabled ? headerNumber(headerText) : std::nullopt;
+    if (!number) {
+        return std::nullopt;
+    }
+    return focusCenter - *number * focusStep;
+}
+
+double MarkColumns::parseValue(const QString& text) {
+    static const QRegularExpression pattern(
+        QStringLiteral("[-+]?(?:\\d+\\.?\\d*|\\.\\d+)(?:[eE][-+]?\\d+)?"));
+    const QRegularExpressionMatch match = pattern.match(text);
+    if (!match.hasMatch()) {
+        return kMissing;
+    }
+    bool ok = false;
+    const double value = QLocale::c().toDouble(match.capturedView(), &ok);
+    return ok ? value : kMissing;
+}
+
+/** @brief 递归下降解析器：词法与语法一趟完成，节点追加到规则的节点表。 */
+class MarkRule::Parser {
+public:
+    Parser(const QString& text, std::vector<Node>& nodes) : m_text(text), m_nodes(nodes) {}
+
+    /** @brief 解析整个表达式，返回根节点下标；失败时返回 -1 并记录 error。 */
+    int parse(QString& error) {
+        advance();
+        const int root = parseOr();
+        if (root >= 0 && m_token.type != Token::End) {
+            fail(QStringLiteral("unexpected '%1'").arg(m_token.text));
+        }
+        error = m_error;
+        return m_error.isEmpty() ? root : -1;
+    }
+
+private:
+    struct Token {
+        enum Type { End, Ident, Number, String, Operator, LParen, RParen, Invalid };
+        Type type = End;
+        QString text;
+        double number = 0.0;
+    };
+
+    const QString& m_text;
+    std::vector<Node>& m_nodes;
+    qsizetype m_pos = 0;
+    Token m_token;
+    QString m_error;
+
+    int fail(const QString& message) {
+        if (m_error.isEmpty()) {
+            m_error = QStringLiteral("%1 at offset %2").arg(message).arg(m_pos);
+        }
+        return -1;
+    }
+
+    bool isKeyword(const char* keyword) const {
+        return m_token.type == Token::Ident &&
+               m_token.text.compare(QLatin1String(keyword), Qt::CaseInsensitive) == 0;
+    }
+
+    bool isOperator(const char* op) const {
+        return m_token.type == Token::Operator && m_token.text == QLatin1String(op);
+    }
+
+    void advance() {
+        while (m_pos < m_text.size() && m_text[m_pos].isSpace()) {
+            ++m_pos;
+        }
+        m_token = Token();
+        if (m_pos >= m_text.size()) {
+            return;
+        }
+
+        const QChar c = m_text[m_pos];
+        const auto peek = [this](qsizetype offset) {
+            return m_pos + offset < m_text.size() ? m_text[m_pos + offset] : QChar();
+        };
+        if (c == '(' || c == ')') {
+            m_token.type = c == '(' ? Token::LParen : Token::RParen;
+            m_token.text = c;
+            ++m_pos;
+        } else if (c == '"') {
+            // 字符串字面量，支持 \" 与 \\ 转义
+            ++m_pos;
+            bool closed = false;
+            while (m_pos < m_text.size()) {
+                const QChar ch = m_text[m_pos++];
+                if (ch == '\\' && m_pos < m_text.size()) {
+                    m_token.text.append(m_text[m_pos++]);
+                } else if (ch == '"') {
+                    closed = true;
+                    break;
+                } else {
+                    m_token.text.append(ch);
+                }
+            }
+            m_token.type = closed ? Token::String : Token::Invalid;
+        } else if (c.isDigit() || c == '.' ||
+                   (c == '-' && (peek(1).isDigit() || peek(1) == '.'))) {
+            // 没有减法运算，负号总是数值的一部分
+            const qsizetype start = m_pos++;
+            while (m_pos < m_text.size() &&
+                   (m_text[m_pos].isDigit() || m_text[m_pos] == '.' || m_text[m_pos] == 'e' ||
+                    m_text[m_pos] == 'E' ||
+                    ((m_text[m_pos] == '-' || m_text[m_pos] == '+') &&
+                     (m_text[m_pos - 1] == 'e' || m_text[m_pos - 1] == 'E')))) {
+                ++m_pos;
+            }
+            m_token.text = m_text.mid(start, m_pos - start);
+            bool ok = false;
+            m_token.number = QLocale::c().toDouble(m_token.text, &ok);
+            m_token.type = ok ? Token::Number : Token::Invalid;
+        } else if (c.isLetter() || c == '_') {
+            const qsizetype start = m_pos;
+            while (m_pos < m_text.size() &&
+                   (m_text[m_pos].isLetterOrNumber() || m_text[m_pos] == '_')) {
+                ++m_pos;
+            }
+            m_token.type = Token::Ident;
+            m_token.text = m_text.mid(start, m_pos - start);
+        } else {
+            static const char* const kOperators[] = {"==", "!=", "<=", ">=", "&&", "||",
+                                                     "<",  ">",  "~",  "!",  "="};
+            for (const char* op : kOperators) {
+                const QLatin1String text(op);
+                if (QStringView(m_text).mid(m_pos).startsWith(text)) {
+                    m_token.type = Token::Operator;
+                    // 单个 = 与 == 等价
+                    m_token.text = text == QLatin1String("=") ? QStringLiteral("==")
+                                                              : QString(text);
+                    m_pos += text.size();
+                    return;
+                }
+            }
+            m_token.type = Token::Invalid;
+            m_token.text = c;
+            ++m_pos;
+        }
+    }
+
+    int append(Node node) {
+        m_nodes.push_back(std::move(node));
+        return static_cast<int>(m_nodes.size()) - 1;
+    }
+
+    int parseOr() {
+        int left = parseAnd();
+        while (left >= 0 && (isKeyword("or") || isOperator("||"))) {
+            advance();
+            const int right = parseAnd();
+            if (right < 0) {
+                return -1;
+            }
+            Node node;
+            node.kind = Node::Kind::Or;
+            node.left = left;
+            node.right = right;
+            left = append(std::move(node));
+        }
+        return left;
+    }
+
+    int parseAnd() {
+        int left = parseUnary();
+        while (left >= 0 && (isKeyword("and") || isOperator("&&"))) {
+            advance();
+            const int right = parseUnary();
+            if (right < 0) {
+                return -1;
+            }
+            Node node;
+            node.kind = Node::Kind::And;
+            node.left = left;
+            node.right = right;
+            left = append(std::move(node));
+        }
+        return left;
+    }
+
+    int parseUnary() {
+        if (isKeyword("not") || isOperator("!")) {
+            advance();
+            const int operand = parseUnary();
+            if (operand < 0) {
+                return -1;
+            }
+            Node node;
+            node.kind = Node::Kind::Not;
+            node.left = operand;
+            return append(std::move(node));
+        }
+        if (m_token.type == Token::LParen) {
+            advance();
+            const int inner = parseOr();
+            if (inner < 0) {
+                return -1;
+            }
+            if (m_token.type != Token::RParen) {
+                return fail(QStringLiteral("expected ')'"));
+            }
+            advance();
+            return inner;
+        }
+        return parseCompare();
+    }
+
+    int parseCompare() {
+        if (m_token.type != Token::Ident) {
+            return fail(m_token.type == Token::End ? QStringLiteral("unexpected end")
+                                                   : QStringLiteral("expected a field"));
+        }
+        Node node;
+        node.kind = Node::Kind::Compare;
+        const QString field = m_token.text.toLower();
+        if (field == QLatin1String("desc")) {
+            node.field = Field::Desc;
+        } else if (field == QLatin1String("value")) {
+            node.field = Field::Value;
+        } else if (field == QLatin1String("dose")) {
+            node.field = Field::Dose;
+        } else if (field == QLatin1String("focus")) {
+            node.field = Field::Focus;
+        } else if (field == QLatin1String("row")) {
+            node.field = Field::Row;
+        } else if (field == QLatin1String("col")) {
+            node.field = Field::Col;
+        } else {
+            return fail(QStringLiteral("unknown field '%1'").arg(m_token.text));
+        }
+        advance();
+
+        if (m_token.type != Token::Operator) {
+            return fail(QStringLiteral("expected a comparison operator"));
+        }
+        static const QPair<const char*, Op> kOps[] = {
+            {"==", Op::Eq}, {"!=", Op::Ne}, {"<", Op::Lt},  {"<=", Op::Le},
+            {">", Op::Gt},  {">=", Op::Ge}, {"~", Op::Match},
+        };
+        bool known = false;
+        for (const auto& [text, op] : kOps) {
+            if (m_token.text == QLatin1String(text)) {
+                node.op = op;
+                known = true;
+            }
+        }
+        if (!known) {
+            return fail(QStringLiteral("unexpected '%1'").arg(m_token.text));
+        }
+        advance();
+
+        // 按字段类型检查字面量与运算符，编译期完成列号换算与正则编译。
+        if (node.field == Field::Desc) {
+            if (m_token.type != Token::String) {
+                return fail(QStringLiteral("desc compares with a string"));
+            }
+            if (node.op != Op::Eq && node.op != Op::Ne && node.op != Op::Match) {
+                return fail(QStringLiteral("desc supports ==, != and ~"));
+            }
+            node.text = m_token.text;
+            if (node.op == Op::Match) {
+                node.regex.setPattern(node.text);
+                if (!node.regex.isValid()) {
+                    return fail(
+                        QStringLiteral("invalid pattern: %1").arg(node.regex.errorString()));
+                }
+                node.regex.optimize();
+            }
+        } else {
+            if (node.op == Op::Match) {
+                return fail(QStringLiteral("~ applies to desc only"));
+            }
+            if (m_token.type == Token::Number) {
+                node.number = m_token.number;
+            } else if (node.field == Field::Col && m_token.type == Token::String) {
+                node.number = columnNumber(m_token.text);
+            } else {
+                return fail(QStringLiteral("%1 compares with a number").arg(field));
+            }
+        }
+        advance();
+        return append(std::move(node));
+    }
+};
+
+/** @brief 对一整列数值做同一比较；缺失值（NaN）的比较恒为假。 */
+template <typename T>
+void MarkRule::compareColumn(const QVector<T>& column, Op op, double operand,
+                             std::vector<char>& mask) {
+    const qsizetype n = column.size();
+    const T* values = column.constData();
+    char* out = mask.data();
+    switch (op) {
+        case Op::Eq:
+            for (qsizetype i = 0; i < n; ++i) out[i] = values[i] == operand;
+            break;
+        case Op::Ne:
+            for (qsizetype i = 0; i < n; ++i) {
+                const double v = values[i];
+                out[i] = v == v && v != operand;
+            }
+            break;
+        case Op::Lt:
+            for (qsizetype i = 0; i < n; ++i) out[i] = values[i] < operand;
+            break;
+        case Op::Le:
+            for (qsizetype i = 0; i < n; ++i) out[i] = values[i] <= operand;
+            break;
+        case Op::Gt:
+            for (qsizetype i = 0; i < n; ++i) out[i] = values[i] > operand;
+            break;
+        case Op::Ge:
+            for (qsizetype i = 0; i < n; ++i) out[i] = values[i] >= operand;
+            break;
+        case Op::Match:
+            break;
+    }
+}
+
+std::optional<MarkRule> MarkRule::compile(const QString& expression, QString* error) {
+    MarkRule rule;
+    rule.m_expression = expression;
+    QString message;
+    Parser parser(rule.m_expression, rule.m_nodes);
+    rule.m_root = parser.parse(message);
+    if (rule.m_root < 0) {
+        if (error) {
+            *error = message;
+        }
+        return std::nullopt;
+    }
+    return rule;
+}
+
+std::vector<char> MarkRule::evaluate(const MarkColumns& columns) const {
+    if (m_root < 0) {
+        return std::vector<char>(static_cast<size_t>(columns.size()), 0);
+    }
+    return evaluateNode(m_root, columns);
+}
+
+std::vector<char> MarkRule::evaluateNode(int index, const MarkColumns& columns) const {
+    const Node& node = m_nodes[static_cast<size_t>(index)];
+    const size_t n = static_cast<size_t>(columns.size());
+    switch (node.kind) {
+        case Node::Kind::And:
+        case Node::Kind::Or: {
+            std::vector<char> mask = evaluateNode(node.left, columns);
+            const std::vector<char> right = evaluateNode(node.right, columns);
+            if (node.kind == Node::Kind::And) {
+                for (size_t i = 0; i < n; ++i) mask[i] &= right[i];
+            } else {
+                for (size_t i = 0; i < n; ++i) mask[i] |= right[i];
+            }
+            return mask;
+        }
+        case Node::Kind::Not: {
+            std::vector<char> mask = evaluateNode(node.left, columns);
+            for (size_t i = 0; i < n; ++i) mask[i] = !mask[i];
+            return mask;
+        }
+        case Node::Kind::Compare:
+            break;
+    }
+
+    std::vector<char> mask(n, 0);
+    switch (node.field) {
+        case Field::Desc:
+            for (size_t i = 0; i < n; ++i) {
+                const QString& desc = columns.desc[static_cast<qsizetype>(i)];
+                if (node.op == Op::Match) {
+                    mask[i] = node.regex.match(desc).hasMatch();
+                } else {
+                    mask[i] = (desc == node.text) == (node.op == Op::Eq);
+                }
+            }
+            break;
+        case Field::Value:
+            compareColumn(columns.value, node.op, node.number, mask);
+            break;
+        case Field::Dose:
+            compareColumn(columns.dose, node.op, node.number, mask);
+            break;
+        case Field::Focus:
+            compareColumn(columns.focus, node.op, node.number, mask);
+            break;
+        case Field::Row:
+            compareColumn(columns.row, node.op, node.number, mask);
+            break;
+        case Field::Col:
+            compareColumn(columns.col, node.op, node.number, mask);
+            break;
+    }
+    return mask;
+}
+
+}  // namespace cc::neolux::fem::xlsxeditor
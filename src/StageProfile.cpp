@@ -0,0 +1,27 @@
+#include "cc/neolux/fem/xlsxeditor/StageProfile.hpp"
+
+#include <QMutexLocker>
+
+namespace cc::neolux::fem::xlsxeditor {
+
+void StageProfile::record(const QString& name, qint64 nsecs, qint64 items, qint64 bytes) {
+    QMutexLocker locker(&m_mutex);
+    // 阶段数很少，线性查找即可。
+    for (auto& timing : m_timings) {
+        if (timing.name == name) {
+            timing.nsecs += nsecs;
+            ++timing.calls;
+            timing.items += items;
+            timing.bytes += bytes;
+            return;
+        }
+    }
+    m_timings.append({name, nsecs, 1, items, bytes});
+}
+
+QVector<StageTiming> StageProfile::timings() const {
+    QMutexLocker locker(&m_mutex);
+    return m_timings;
+}
+
+}  // namespace cc::neolux::fem::xlsxeditor
@@ -0,0 +1,157 @@
+#include "cc/neolux/fem/xlsxeditor/ThumbnailDiskCache.hpp"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <atomic>
+
+namespace {
+constexpr quint32 kMagic = 0x4D485445;  // "ETHM"
+constexpr quint16 kVersion = 1;
+constexpr auto kStreamVersion = QDataStream::Qt_6_0;
+const char* const kSuffix = ".thumb";
+// 淘汰到预算的 90%，避免每次加载都触发淘汰。
+constexpr double kTrimTarget = 0.9;
+}  // namespace
+
+namespace cc::neolux::fem::xlsxeditor {
+
+ThumbnailDiskCache::ThumbnailDiskCache(const QString& directory, qint64 budgetBytes)
+    : m_directory(directory), m_budget(budgetBytes) {}
+
+QString ThumbnailDiskCache::defaultDirectory() {
+    const QString base = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    return base.isEmpty() ? QString() : QDir(base).filePath(QStringLiteral("thumbnails"));
+}
+
+QString ThumbnailDiskCache::keyFor(const ZipArchive::Entry& entry, int side) {
+    return QStringLiteral("%1-%2-%3-%4")
+        .arg(entry.crc32, 8, 16, QLatin1Char('0'))
+        .arg(entry.uncompressedSize)
+        .arg(entry.compressedSize)
+        .arg(side);
+}
+
+bool ThumbnailDiskCache::load(const QString& key, int side, QSize& imageSize,
+                              QImage& thumbnail) const {
+    if (!isEnabled()) {
+        return false;
+    }
+    QFile file(filePath(key));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(kStreamVersion);
+    quint32 magic = 0;
+    quint16 version = 0;
+    qint32 width = 0;
+    qint32 height = 0;
+    qint32 format = 0;
+    in >> magic >> version >> imageSize >> width >> height >> format;
+    // 缓存文件可能损坏或被替换：尺寸先于分配校验，缩略图不会超过边长上限，也不会大于原图。
+    if (in.status() != QDataStream::Ok || magic != kMagic || version != kVersion ||
+        width <= 0 || height <= 0 || width > side || height > side || !imageSize.isValid() ||
+        width > imageSize.width() || height > imageSize.height() ||
+        (format != QImage::Format_RGB32 && format != QImage::Format_ARGB32_Premultiplied)) {
+        return false;
+    }
+    const qsizetype rowBytes = static_cast<qsizetype>(width) * 4;
+    if (file.size() - file.pos() != rowBytes * height) {
+        return false;
+    }
+
+    // 按行读取原始像素，不经过图片编解码。
+    QImage image(width, height, static_cast<QImage::Format>(format));
+    if (image.isNull()) {
+        return false;
+    }
+    for (int y = 0; y < height; ++y) {
+        if (in.readRawData(reinterpret_cast<char*>(image.scanLine(y)), rowBytes) != rowBytes) {
+            return false;
+        }
+    }
+    file.close();
+    thumbnail = image;
+    touch(file.fileName());
+    return true;
+}
+
+void ThumbnailDiskCache::touch(const QString& path) {
+    // 以修改时间记录最近访问，供 trim 做 LRU 淘汰；部分平台只允许对可写句柄设置时间。
+    QFile file(path);
+    if (file.open(QIODevice::ReadWrite | QIODevice::ExistingOnly) &&
+        file.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime)) {
+        return;
+    }
+    // 缓存目录只读等情况下每次命中都会失败，只提示一次。
+    static std::atomic<bool> warned{false};
+    if (!warned.exchange(true)) {
+        qWarning() << "Failed to refresh thumbnail cache access time:" << path
+                   << file.errorString();
+    }
+}
+
+bool ThumbnailDiskCache::store(const QString& key, const QSize& imageSize,
+                               const QImage& thumbnail) const {
+    if (!isEnabled() || thumbnail.isNull() || !QDir().mkpath(m_directory)) {
+        return false;
+    }
+    const QImage image = thumbnail.convertToFormat(thumbnail.hasAlphaChannel()
+                                                       ? QImage::Format_ARGB32_Premultiplied
+                                                       : QImage::Format_RGB32);
+
+    QSaveFile file(filePath(key));
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    QDataStream out(&file);
+    out.setVersion(kStreamVersion);
+    out << kMagic << kVersion << imageSize << qint32(image.width()) << qint32(image.height())
+        << qint32(image.format());
+    const int rowBytes = image.width() * 4;
+    for (int y = 0; y < image.height(); ++y) {
+        out.writeRawData(reinterpret_cast<const char*>(image.constScanLine(y)), rowBytes);
+    }
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+void ThumbnailDiskCache::trim() const {
+    if (m_directory.isEmpty()) {
+        return;
+    }
+    QDir dir(m_directory);
+    // 按修改时间由新到旧排列，累计超出预算后的文件全部删除。
+    const QFileInfoList files = dir.entryInfoList({QStringLiteral("*") + kSuffix}, QDir::Files,
+                                                  QDir::Time);
+    qint64 total = 0;
+    for (const auto& info : files) {
+        total += info.size();
+    }
+    if (total <= m_budget) {
+        return;
+    }
+    const qint64 target = static_cast<qint64>(static_cast<double>(m_budget) * kTrimTarget);
+    qint64 kept = 0;
+    bool evicting = false;
+    for (const auto& info : files) {
+        evicting = evicting || kept + info.size() > target;
+        if (evicting) {
+            QFile::remove(info.absoluteFilePath());
+        } else {
+            kept += info.size();
+        }
+    }
+}
+
+QString ThumbnailDiskCache::filePath(const QString& key) const {
+    return QDir(m_directory).filePath(key + kSuffix);
+}
+
+}  // namespace cc::neolux::fem::xlsxeditor
@@ -0,0 +1,158 @@
+#include "cc/neolux/fem/xlsxeditor/Tracer.hpp"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    qint64 startNs;
+    qint64 durationNs;
+    int tid;
+    QString detail;
+};
+
+QMutex g_mutex;
+std::vector<TraceEvent> g_events;
+QHash<int, QString> g_threadNames;  // 跟踪线程号 -> 线程名，跨多次记录保留
+std::atomic<int> g_nextTid{1};
+QString g_environmentPath;
+
+QElapsedTimer& traceClock() {
+    static QElapsedTimer timer = [] {
+        QElapsedTimer started;
+        started.start();
+        return started;
+    }();
+    return timer;
+}
+
+/** @brief 当前线程的跟踪线程号：按首次记录顺序编号，比系统线程号更易读。 */
+int currentTid(bool& isNew) {
+    thread_local int tid = 0;
+    isNew = tid == 0;
+    if (isNew) {
+        tid = g_nextTid.fetch_add(1);
+    }
+    return tid;
+}
+
+QString currentThreadName(int tid) {
+    const QCoreApplication* app = QCoreApplication::instance();
+    if (app && QThread::currentThread() == app->thread()) {
+        return QStringLiteral("main");
+    }
+    const QString name = QThread::currentThread()->objectName();
+    return QStringLiteral("%1 #%2")
+        .arg(name.isEmpty() ? QStringLiteral("thread") : name)
+        .arg(tid);
+}
+
+void writeAtExit() {
+    if (!cc::neolux::fem::xlsxeditor::Tracer::stop(g_environmentPath)) {
+        qWarning() << "Failed to write trace:" << g_environmentPath;
+    }
+}
+
+}  // namespace
+
+namespace cc::neolux::fem::xlsxeditor {
+
+void Tracer::start() {
+    QMutexLocker locker(&g_mutex);
+    g_events.clear();
+    traceClock();
+    s_enabled.store(true, std::memory_order_relaxed);
+}
+
+bool Tracer::stop(const QString& path) {
+    std::vector<TraceEvent> events;
+    QHash<int, QString> threadNames;
+    {
+        QMutexLocker locker(&g_mutex);
+        s_enabled.store(false, std::memory_order_relaxed);
+        events.swap(g_events);
+        threadNames = g_threadNames;
+    }
+
+    // Chrome trace 的时间单位为微秒；完整事件（ph = X）自带持续时间，无需配对。
+    const qint64 pid = QCoreApplication::instance() ? QCoreApplication::applicationPid() : 1;
+    QJsonArray traceEvents;
+    for (auto it = threadNames.constBegin(); it != threadNames.constEnd(); ++it) {
+        traceEvents.append(QJsonObject{{QStringLiteral("name"), QStringLiteral("thread_name")},
+                                       {QStringLiteral("ph"), QStringLiteral("M")},
+                                       {QStringLiteral("pid"), pid},
+                                       {QStringLiteral("tid"), it.key()},
+                                       {QStringLiteral("args"),
+                                        QJsonObject{{QStringLiteral("name"), it.value()}}}});
+    }
+    for (const auto& event : events) {
+        QJsonObject object{{QStringLiteral("name"), QString::fromLatin1(event.name)},
+                           {QStringLiteral("cat"), QStringLiteral("xlsxeditor")},
+                           {QStringLiteral("ph"), QStringLiteral("X")},
+                           {QStringLiteral("ts"), event.startNs / 1000.0},
+                           {QStringLiteral("dur"), event.durationNs / 1000.0},
+                           {QStringLiteral("pid"), pid},
+                           {QStringLiteral("tid"), event.tid}};
+        if (!event.detail.isEmpty()) {
+            object.insert(QStringLiteral("args"),
+                          QJsonObject{{QStringLiteral("detail"), event.detail}});
+        }
+        traceEvents.append(object);
+    }
+    const QJsonObject root{{QStringLiteral("traceEvents"), traceEvents},
+                           {QStringLiteral("displayTimeUnit"), QStringLiteral("ms")}};
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    return file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) >= 0;
+}
+
+void Tracer::startFromEnvironment() {
+    static std::once_flag once;
+    std::call_once(once, [] {
+        g_environmentPath = qEnvironmentVariable("XLSXEDITOR_TRACE");
+        if (g_environmentPath.isEmpty()) {
+            return;
+        }
+        start();
+        qAddPostRoutine(writeAtExit);
+    });
+}
+
+qint64 Tracer::now() {
+    return traceClock().nsecsElapsed();
+}
+
+void Tracer::complete(const char* name, qint64 startNs, qint64 durationNs,
+                      const QString& detail) {
+    bool isNewThread = false;
+    const int tid = currentTid(isNewThread);
+    const QString threadName = isNewThread ? currentThreadName(tid) : QString();
+
+    QMutexLocker locker(&g_mutex);
+    if (isNewThread) {
+        g_threadNames.insert(tid, threadName);
+    }
+    // 计时期间可能已被 stop，此时丢弃事件。
+    if (!isEnabled()) {
+        return;
+    }
+    g_events.push_back({name, startNs, durationNs, tid, detail});
+}
+
+}  // namespace cc::neolux::fem::xlsxeditor
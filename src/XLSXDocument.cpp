@@ -0,0 +1,1320 @@
+#include "cc/neolux/fem/xlsxeditor/XLSXDocument.hpp"
+
+#include <QBuffer>
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QImageReader>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPromise>
+#include <QTemporaryFile>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentRun>
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <limits>
+#include <set>
+#include <utility>
+
+#include "cc/neolux/fem/xlsxeditor/CellRef.hpp"
+
+namespace {
+constexpr unsigned long kLoadPollIntervalMs = 10;
+// 缩略图边长：覆盖最大缩放（2.5 倍）下 66px 的图标
+constexpr int kThumbnailSide = 166;
+
+/** @brief 单张图片的解码任务（工作线程只读取归档条目与解码）。 */
+struct PictureJob {
+    int row;
+    int col;
+    std::string mediaPath;
+};
+
+/** @brief 解码任务的产出：常驻的压缩数据、原图尺寸与网格缩略图金字塔。 */
+struct DecodedPicture {
+    QByteArray bytes;
+    QSize size;
+    cc::neolux::fem::xlsxeditor::ImagePyramid thumbnails;
+};
+
+DecodedPicture decodePictureJob(const cc::neolux::fem::xlsxeditor::ZipArchive& archive,
+                                const cc::neolux::fem::xlsxeditor::ThumbnailDiskCache& cache,
+                                cc::neolux::fem::xlsxeditor::StageProfile* profile,
+                                const PictureJob& job) {
+    using cc::neolux::fem::xlsxeditor::StageTimer;
+    using cc::neolux::fem::xlsxeditor::Tracer;
+    const cc::neolux::fem::xlsxeditor::TraceSpan span(
+        "decode.picture",
+        Tracer::isEnabled() ? QString::fromStdString(job.mediaPath) : QString());
+    DecodedPicture decoded;
+    const cc::neolux::fem::xlsxeditor::ZipArchive::Entry* entry = archive.find(job.mediaPath);
+    if (!entry) {
+        qWarning() << "Image entry not found:" << QString::fromStdString(job.mediaPath);
+        return decoded;
+    }
+
+    // 磁盘缓存命中时既不解压也不解码；原始数据留待全分辨率预览时再读取。
+    const QString cacheKey =
+        cache.isEnabled() ? cc::neolux::fem::xlsxeditor::ThumbnailDiskCache::keyFor(
+                                *entry, kThumbnailSide)
+                          : QString();
+    QImage cached;
+    if (!cacheKey.isEmpty()) {
+        StageTimer timer(profile, "decode.diskCache");
+        if (cache.load(cacheKey, kThumbnailSide, decoded.size, cached)) {
+            timer.addItems(1);
+            decoded.thumbnails = cc::neolux::fem::xlsxeditor::ImagePyramid::build(cached);
+            return decoded;
+        }
+    }
+
+    std::string bytes;
+    {
+        StageTimer timer(profile, "decode.unzip");
+        if (!archive.read(*entry, bytes)) {
+            qWarning() << "Failed to read image entry:" << QString::fromStdString(job.mediaPath);
+            return decoded;
+        }
+        timer.addItems(1);
+        timer.addBytes(static_cast<qint64>(bytes.size()));
+    }
+    QByteArray data(bytes.data(), static_cast<qsizetype>(bytes.size()));
+    bytes.clear();
+
+    // 缩略图走解码器内置的降采样（JPEG 按 DCT 缩放），不生成全分辨率图片；
+    // 全分辨率图片仅在悬停预览或导出时经缓存解码。
+    StageTimer decodeTimer(profile, "decode.image");
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader reader(&buffer);
+    const QSize sourceSize = reader.size();
+    if (sourceSize.isValid()) {
+        const QSize target =
+            sourceSize.scaled(kThumbnailSide, kThumbnailSide, Qt::KeepAspectRatio);
+        if (target.width() < sourceSize.width()) {
+            reader.setScaledSize(target);
+        }
+    }
+    QImage thumbnail = reader.read();
+    buffer.close();
+    if (thumbnail.isNull()) {
+        qWarning() << "Failed to load image from" << QString::fromStdString(job.mediaPath)
+                   << reader.errorString();
+        return decoded;
+    }
+
+    // 部分格式不提供头部尺寸信息，此时退回完整解码后缩放。
+    decoded.size = sourceSize.isValid() ? sourceSize : thumbnail.size();
+    if (thumbnail.width() > kThumbnailSide || thumbnail.height() > kThumbnailSide) {
+        thumbnail = thumbnail.scaled(kThumbnailSide, kThumbnailSide, Qt::KeepAspectRatio,
+                                     Qt::SmoothTransformation);
+    }
+    decodeTimer.addItems(1);
+    decodeTimer.addBytes(data.size());
+    decodeTimer.stop();
+    if (!cacheKey.isEmpty()) {
+        cache.store(cacheKey, decoded.size, thumbnail);
+    }
+    // 金字塔在工作线程中一次建好，缩放时界面线程只做小尺寸重采样。
+    StageTimer pyramidTimer(profile, "decode.pyramid");
+    decoded.thumbnails = cc::neolux::fem::xlsxeditor::ImagePyramid::build(thumbnail);
+    pyramidTimer.addItems(1);
+    decoded.bytes = data;
+    return decoded;
+}
+
+bool splitCellRef(const QString& ref, QString& colPart, QString& rowPart) {
+    colPart.clear();
+    rowPart.clear();
+    for (QChar c : ref.trimmed()) {
+        if (c.isLetter()) {
+            colPart.append(c.toUpper());
+        } else if (c.isDigit()) {
+            rowPart.append(c);
+        }
+    }
+    return !colPart.isEmpty() && !rowPart.isEmpty();
+}
+}  // namespace
+
+namespace cc::neolux::fem::xlsxeditor {
+
+/**
+ * @brief 后台加载任务的一次产出；加载被放弃时已打开的包随结构析构关闭。
+ *
+ * 一次加载依次产出：一个 Layout（数据项、描述与表头，图片待解码），
+ * 若干 Pictures（一批已解码的图片），最后一个 Finished（已打开的包或错误）。
+ * 打开或枚举失败时只产出带错误的 Finished。
+ */
+struct LoadResult {
+    enum class Kind { Layout, Pictures, Finished };
+
+    Kind kind = Kind::Finished;
+    QVector<DataEntry> data;               // Layout
+    CellTable cells;                       // Layout：描述与表头单元格
+    QByteArray contentHash;                // Layout：工作簿内容指纹
+    QVector<int> indices;                  // Pictures：数据项索引
+    QVector<DecodedPicture> pictures;      // Pictures：与 indices 一一对应
+    std::unique_ptr<XLSXPackage> package;  // Finished：已打开的包，供按需读取图片原始数据
+    QString error;                         // Finished
+};
+
+/**
+ * @brief 解码队列：解码线程按优先顺序取任务，界面线程可随时调整顺序。
+ *
+ * 优先列表（通常是视口内及附近的单元格）中的任务先分发，其余按锚点顺序。
+ * 锁内只做常数工作或与优先列表长度成正比的工作，不随图片总数增长。
+ */
+struct DecodeQueue {
+    /** @brief 以 count 个任务重新开始，清空优先列表。 */
+    void reset(int count) {
+        QMutexLocker locker(&mutex);
+        taken.assign(count, false);
+        urgent.clear();
+        urgentPos = 0;
+        nextInOrder = 0;
+        canceled = false;
+    }
+
+    /** @brief 用新的优先列表替换旧的；已分发或越界的索引被忽略。 */
+    void prioritize(const QVector<int>& indices) {
+        QMutexLocker locker(&mutex);
+        urgent.clear();
+        urgentPos = 0;
+        for (const int index : indices) {
+            if (index >= 0 && index < static_cast<int>(taken.size()) && !taken[index]) {
+                urgent.append(index);
+            }
+        }
+    }
+
+    /** @brief 取出下一个任务；全部分发完或已取消时返回 -1。 */
+    int take() {
+        QMutexLocker locker(&mutex);
+        if (canceled) {
+            return -1;
+        }
+        while (urgentPos < urgent.size()) {
+            const int index = urgent[urgentPos++];
+            if (!taken[index]) {
+                taken[index] = true;
+                return index;
+            }
+        }
+        while (nextInOrder < static_cast<int>(taken.size())) {
+            const int index = nextInOrder++;
+            if (!taken[index]) {
+                taken[index] = true;
+                return index;
+            }
+        }
+        return -1;
+    }
+
+    /** @brief 停止分发，之后 take 均返回 -1。 */
+    void cancel() {
+        QMutexLocker locker(&mutex);
+        canceled = true;
+    }
+
+    QMutex mutex;
+    std::vector<bool> taken;  // 已分发的任务
+    QVector<int> urgent;      // 优先列表
+    qsizetype urgentPos = 0;
+    int nextInOrder = 0;  // 锚点顺序的下一个候选
+    bool canceled = false;
+};
+
+}  // namespace cc::neolux::fem::xlsxeditor
+
+namespace {
+using cc::neolux::fem::xlsxeditor::CellEdit;
+using cc::neolux::fem::xlsxeditor::CellRange;
+using cc::neolux::fem::xlsxeditor::DataEntry;
+using cc::neolux::fem::xlsxeditor::DecodeQueue;
+using cc::neolux::fem::xlsxeditor::ImagePyramid;
+using cc::neolux::fem::xlsxeditor::LoadResult;
+using cc::neolux::fem::xlsxeditor::PackageRewriter;
+using cc::neolux::fem::xlsxeditor::StageProfile;
+using cc::neolux::fem::xlsxeditor::StageTimer;
+using cc::neolux::fem::xlsxeditor::ThumbnailDiskCache;
+using cc::neolux::fem::xlsxeditor::TraceSpan;
+using cc::neolux::fem::xlsxeditor::Tracer;
+using cc::neolux::fem::xlsxeditor::XLSXDocument;
+using cc::neolux::fem::xlsxeditor::XLSXPackage;
+using cc::neolux::fem::xlsxeditor::ZipArchive;
+using LoadWatcher = QFutureWatcher<std::shared_ptr<LoadResult>>;
+using SaveWatcher = QFutureWatcher<bool>;
+
+// 独立的解码线程池：加载任务本身运行在全局线程池中，嵌套等待不会占满同一个池。
+Q_GLOBAL_STATIC(QThreadPool, g_decodePool)
+
+struct LoadRequest {
+    QString filePath;
+    QString sheetName;
+    int startRow;
+    int startCol;
+    int endRow;
+    int endCol;
+    ThumbnailDiskCache thumbnailCache;
+    std::shared_ptr<StageProfile> profile;  // 未开启计时时为空
+    std::shared_ptr<DecodeQueue> decodeQueue;
+    bool decodePictures;  // false 时只产出布局
+};
+
+LoadRequest makeLoadRequest(const QString& filePath, const QString& sheetName,
+                            const QString& range, const ThumbnailDiskCache& thumbnailCache,
+                            const std::shared_ptr<StageProfile>& profile,
+                            const std::shared_ptr<DecodeQueue>& decodeQueue,
+                            bool decodePictures) {
+    LoadRequest request{filePath,       sheetName, 0,           0, 0, 0,
+                        thumbnailCache, profile,   decodeQueue, decodePictures};
+    XLSXDocument::parseRange(range, request.startRow, request.startCol, request.endRow,
+                             request.endCol);
+    return request;
+}
+
+/**
+ * @brief 在工作线程中完成打开、图片枚举、描述读取与并行解码。
+ *
+ * 布局（锚点、描述与表头）在解码前产出，已解码的图片按轮询间隔成批产出，
+ * 界面因此无需等待全部解码即可显示网格。
+ * 每个阶段之间检查取消标记；被取消时不再产出结果，已打开的包随之释放。
+ */
+void runLoadJob(QPromise<std::shared_ptr<LoadResult>>& promise, const LoadRequest& request) {
+    auto result = std::make_shared<LoadResult>();
+    auto fail = [&promise, &result](const QString& message) {
+        result->error = message;
+        promise.addResult(result);
+    };
+
+    StageProfile* profile = request.profile.get();
+    const TraceSpan span("load.job", request.filePath);
+
+    // 仅索引中央目录，范围内的图片条目按需直接解压到内存，不再整体解压到临时目录。
+    auto package = std::make_unique<XLSXPackage>();
+    {
+        StageTimer timer(profile, "load.open");
+        if (!package->open(request.filePath.toStdString())) {
+            fail(QCoreApplication::translate("XLSXEditor", "Failed to open XLSX file."));
+            return;
+        }
+        if (profile) {
+            timer.addBytes(QFileInfo(request.filePath).size());
+        }
+    }
+    if (promise.isCanceled()) {
+        return;
+    }
+    // 中央目录包含每个条目的 CRC32 与尺寸，作为工作簿内容指纹无需读取整个文件。
+    {
+        StageTimer timer(profile, "load.fingerprint");
+        const std::string& centralDirectory = package->archive().centralDirectory();
+        result->contentHash = QCryptographicHash::hash(
+            QByteArrayView(centralDirectory.data(),
+                           static_cast<qsizetype>(centralDirectory.size())),
+            QCryptographicHash::Sha1);
+        timer.addBytes(static_cast<qint64>(centralDirectory.size()));
+    }
+
+    StageTimer enumerateTimer(profile, "load.enumerate");
+    const int sheetIndex = package->sheetIndex(request.sheetName.toStdString());
+    if (sheetIndex < 0) {
+        fail(QCoreApplication::translate("XLSXEditor", "Sheet not found: %1")
+                 .arg(request.sheetName));
+        return;
+    }
+
+    // 通过包结构的关系链获取表内图片
+    const auto allPictures = package->sheetPictures(sheetIndex);
+    QVector<PictureJob> jobs;
+    for (const auto& pic : allPictures) {
+        if (pic.rowNum < request.startRow || pic.rowNum > request.endRow ||
+            pic.colNum < request.startCol || pic.colNum > request.endCol) {
+            continue;
+        }
+        jobs.append({pic.rowNum, pic.colNum, pic.mediaPath});
+    }
+    enumerateTimer.addItems(jobs.size());
+    enumerateTimer.stop();
+    promise.setProgressRange(0, static_cast<int>(jobs.size()));
+
+    // 单次遍历工作表读取描述（图片下方一行）与表头（第 2 行、第 1 列）。
+    StageTimer cellsTimer(profile, "load.cells");
+    const std::vector<CellRange> cellRanges = {
+        {request.startRow + 1, request.startCol, request.endRow + 1, request.endCol},
+        {2, request.startCol, 2, request.endCol},
+        {request.startRow, 1, request.endRow, 1},
+    };
+    auto layout = std::make_shared<LoadResult>();
+    layout->kind = LoadResult::Kind::Layout;
+    layout->contentHash = result->contentHash;
+    // 工作表解析失败时描述全部为空，按此保存会抹掉原有描述，必须整体失败。
+    if (!package->readCells(sheetIndex, cellRanges, layout->cells)) {
+        fail(QCoreApplication::translate("XLSXEditor", "Failed to read cells of sheet: %1")
+                 .arg(request.sheetName));
+        return;
+    }
+    const std::vector<bool> filledStyles = package->filledStyles();
+    cellsTimer.addItems(static_cast<qint64>(layout->cells.size()));
+    cellsTimer.stop();
+
+    // 布局先于图片产出：图片字段留空并标记为待解码。
+    StageTimer assembleTimer(profile, "load.assemble");
+    layout->data.reserve(jobs.size());
+    for (const PictureJob& job : std::as_const(jobs)) {
+        const QString value =
+            QString::fromStdString(layout->cells.text(job.row + 1, job.col)).trimmed();
+        const int style = layout->cells.styleIndex(job.row + 1, job.col);
+        const bool filled = style > 0 && style < static_cast<int>(filledStyles.size()) &&
+                            filledStyles[style];
+        layout->data.append({job.row, job.col, QByteArray(), job.mediaPath, QSize(),
+                             ImagePyramid(), value, false, value, filled, true});
+    }
+    assembleTimer.addItems(jobs.size());
+    assembleTimer.stop();
+    if (promise.isCanceled()) {
+        return;
+    }
+    // 队列先于布局就绪，界面收到布局后即可按视口调整解码顺序。
+    DecodeQueue& queue = *request.decodeQueue;
+    queue.reset(static_cast<int>(jobs.size()));
+    promise.addResult(layout);
+    layout.reset();
+    // 仅布局：不解码也不读写缩略图缓存，图片保持待解码，需要时经 pictureAt 按需解码。
+    if (!request.decodePictures) {
+        result->package = std::move(package);
+        promise.setProgressValue(static_cast<int>(jobs.size()));
+        promise.addResult(result);
+        return;
+    }
+
+    // 并行解码：各解码线程从队列按优先顺序取任务，解码后放入待发批次；
+    // 轮询时整批产出并转发进度、响应取消。
+    // load.decode 为墙钟时间，decode.* 子阶段为各解码线程耗时之和。
+    StageTimer decodeTimer(profile, "load.decode");
+    const ZipArchive& archive = package->archive();
+    const ThumbnailDiskCache& cache = request.thumbnailCache;
+    QMutex batchMutex;
+    auto batch = std::make_shared<LoadResult>();
+    auto flushBatch = [&promise, &batchMutex, &batch]() {
+        auto ready = std::make_shared<LoadResult>();
+        {
+            QMutexLocker locker(&batchMutex);
+            if (batch->indices.isEmpty()) {
+                return;
+            }
+            std::swap(ready, batch);
+        }
+        ready->kind = LoadResult::Kind::Pictures;
+        promise.addResult(ready);
+    };
+    std::atomic<int> decodedCount{0};
+    auto decodeWorker = [&queue, &archive, &cache, profile, &jobs, &batchMutex, &batch,
+                         &decodedCount]() {
+        for (int i = queue.take(); i >= 0; i = queue.take()) {
+            DecodedPicture picture = decodePictureJob(archive, cache, profile, jobs.at(i));
+            QMutexLocker locker(&batchMutex);
+            batch->indices.append(i);
+            batch->pictures.append(std::move(picture));
+            decodedCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+    const int workerCount =
+        std::min(g_decodePool()->maxThreadCount(), static_cast<int>(jobs.size()));
+    QList<QFuture<void>> workers;
+    for (int i = 0; i < workerCount; ++i) {
+        workers.append(QtConcurrent::run(g_decodePool(), decodeWorker));
+    }
+    auto decoding = [&workers]() {
+        return std::any_of(workers.cbegin(), workers.cend(),
+                           [](const QFuture<void>& worker) { return !worker.isFinished(); });
+    };
+    while (decoding()) {
+        if (promise.isCanceled()) {
+            queue.cancel();
+            break;
+        }
+        promise.setProgressValue(decodedCount.load(std::memory_order_relaxed));
+        flushBatch();
+        QThread::msleep(kLoadPollIntervalMs);
+    }
+    // 归档需在所有解码任务退出后才能关闭；取消后各线程做完手头的一张即退出。
+    for (QFuture<void>& worker : workers) {
+        worker.waitForFinished();
+    }
+    if (promise.isCanceled()) {
+        return;
+    }
+    flushBatch();
+    decodeTimer.addItems(jobs.size());
+    decodeTimer.stop();
+
+    // 包保持打开并交给文档，缩略图命中缓存的图片按需从中读取原始数据。
+    result->package = std::move(package);
+    StageTimer trimTimer(profile, "load.diskCacheTrim");
+    cache.trim();
+    trimTimer.stop();
+    promise.setProgressValue(static_cast<int>(jobs.size()));
+    promise.addResult(result);
+}
+
+/** @brief 取出加载的终结结果；任务被取消或未正常结束时返回空。 */
+std::shared_ptr<LoadResult> finalResult(const QFuture<std::shared_ptr<LoadResult>>& future) {
+    const int count = future.resultCount();
+    if (count == 0) {
+        return nullptr;
+    }
+    std::shared_ptr<LoadResult> result = future.resultAt(count - 1);
+    return result->kind == LoadResult::Kind::Finished ? result : nullptr;
+}
+
+/** @brief 保存时的数据项快照：只含写回与删除所需字段，工作线程不访问文档状态。 */
+struct SaveEntry {
+    int row;
+    int col;
+    QString desc;
+    bool deleted;
+    bool write;  // 描述单元格与源文件不同，需要写回
+};
+
+struct SaveRequest {
+    QString sourcePath;
+    QString targetPath;
+    QString sheetName;
+    bool dryRun;
+    QVector<SaveEntry> entries;
+    std::shared_ptr<StageProfile> profile;  // 未开启计时时为空
+};
+
+SaveRequest makeSaveRequest(const QString& sourcePath, const QString& targetPath,
+                            const QString& sheetName, bool dryRun,
+                            const QVector<DataEntry>& data,
+                            const std::shared_ptr<StageProfile>& profile) {
+    StageTimer timer(profile.get(), "save.snapshot");
+    SaveRequest request{QFileInfo(sourcePath).absoluteFilePath(), targetPath, sheetName, dryRun,
+                        {}, profile};
+    request.entries.reserve(data.size());
+    for (const auto& entry : data) {
+        request.entries.append(
+            {entry.row, entry.col, entry.desc, entry.deleted, entry.differsFromSource()});
+    }
+    timer.addItems(request.entries.size());
+    return request;
+}
+
+/**
+ * @brief 完成整个保存流程：由源文件与编辑快照直接写出目标文件。
+ *
+ * 源文件只读一次、目标文件只写一次：描述单元格与样式在内存中改写，真删除时同时去掉图片，
+ * 其余条目原样复制压缩数据。结果先写入同目录的临时文件，成功后替换目标文件。
+ * 只使用请求中的快照与本任务自己打开的只读包，可在工作线程中运行，期间可继续编辑。
+ */
+void runSaveJob(QPromise<bool>& promise, const SaveRequest& request) {
+    promise.setProgressRange(0, 3);
+    StageProfile* profile = request.profile.get();
+    const TraceSpan span("save.job", request.targetPath);
+
+    StageTimer openTimer(profile, "save.open");
+    XLSXPackage package;
+    if (!package.open(request.sourcePath.toStdString())) {
+        qWarning() << "Failed to open source xlsx:" << request.sourcePath;
+        promise.addResult(false);
+        return;
+    }
+    const int sheetIndex = package.sheetIndex(request.sheetName.toStdString());
+    PackageRewriter rewriter(package);
+    if (profile) {
+        openTimer.addBytes(QFileInfo(request.sourcePath).size());
+    }
+    openTimer.stop();
+
+    // 假删除标红描述单元格；真删除清空已删除项的描述，且不保留标记样式。
+    StageTimer cellsTimer(profile, "save.cells");
+    std::vector<CellEdit> edits;
+    std::set<std::pair<int, int>> deletedCells;
+    for (const auto& entry : request.entries) {
+        if (entry.deleted) {
+            deletedCells.insert({entry.row, entry.col});
+        }
+        if (!entry.write) {
+            continue;
+        }
+        const bool clearValue = !request.dryRun && entry.deleted;
+        edits.push_back({entry.row + 1, entry.col,
+                         clearValue ? std::string() : entry.desc.toStdString(),
+                         request.dryRun && entry.deleted ? "FFFF0000" : ""});
+    }
+    if (!rewriter.writeCells(sheetIndex, edits)) {
+        qWarning() << "fail to save cell modifications";
+        promise.addResult(false);
+        return;
+    }
+    cellsTimer.addItems(static_cast<qint64>(edits.size()));
+    cellsTimer.stop();
+    promise.setProgressValue(1);
+
+    if (!request.dryRun) {
+        StageTimer picturesTimer(profile, "save.pictures");
+        if (!rewriter.removePictures(sheetIndex, deletedCells)) {
+            qWarning() << "Failed to remove deleted pictures";
+            promise.addResult(false);
+            return;
+        }
+        picturesTimer.addItems(static_cast<qint64>(deletedCells.size()));
+    }
+    promise.setProgressValue(2);
+
+    // 临时文件名在目标目录中唯一，同一目标的并发保存不会互相覆盖半成品；
+    // 失败时 QTemporaryFile 析构删除残留，成功改名后原名已不存在。
+    const std::string targetPath = request.targetPath.toStdString();
+    QTemporaryFile partialFile(request.targetPath + QStringLiteral(".XXXXXX.tmp"));
+    if (!partialFile.open()) {
+        qWarning() << "Failed to create temporary file next to:" << request.targetPath;
+        promise.addResult(false);
+        return;
+    }
+    partialFile.close();
+    const std::string partialPath = partialFile.fileName().toStdString();
+    StageTimer writeTimer(profile, "save.write");
+    const bool written = rewriter.write(partialPath);
+    package.close();
+    if (profile && written) {
+        writeTimer.addBytes(QFileInfo(QString::fromStdString(partialPath)).size());
+    }
+    writeTimer.stop();
+    std::error_code ec;
+    if (written) {
+        StageTimer replaceTimer(profile, "save.replace");
+        std::filesystem::rename(partialPath, targetPath, ec);
+    }
+    if (!written || ec) {
+        qWarning() << "Failed to write filtered xlsx target:" << request.targetPath;
+        promise.addResult(false);
+        return;
+    }
+    promise.setProgressValue(3);
+    promise.addResult(true);
+}
+}  // namespace
+
+namespace cc::neolux::fem::xlsxeditor {
+
+XLSXDocument::XLSXDocument(QObject* parent, bool dryRun)
+    : QObject(parent),
+      m_dryRun(dryRun),
+      m_journalEnabled(true),
+      m_decodePictures(true),
+      m_profilingEnabled(false),
+      m_deletedCount(0),
+      m_imageCacheBudget(ImageCache::kDefaultBudgetBytes),
+      m_memoryBudget(0),
+      m_pictureBytes(0),
+      m_thumbnailBytes(0),
+      m_cellBytes(0),
+      m_iconBytes(0),
+      m_previewBytes(0),
+      m_iconLimit(-1),
+      m_loadGeneration(0),
+      m_savePending(false),
+      m_loadTraceStart(-1) {
+    Tracer::startFromEnvironment();
+}
+
+XLSXDocument::~XLSXDocument() {
+    cancelLoad();
+    // 保存任务不可中途放弃，否则目标文件可能只写了一半。
+    m_saveFuture.waitForFinished();
+}
+
+bool XLSXDocument::parseRange(const QString& range, int& startRow, int& startCol, int& endRow,
+                              int& endCol) {
+    startRow = 0;
+    startCol = 0;
+    endRow = 0;
+    endCol = 0;
+
+    QString trimmed = range.trimmed();
+    if (trimmed.contains(',')) {
+        // 格式：A:C,1:10
+        QStringList parts = trimmed.split(',');
+        if (parts.size() == 2) {
+            QString colPart = parts[0];
+            QString rowPart = parts[1];
+            QStringList colRange = colPart.split(':');
+            if (colRange.size() == 2) {
+                startCol = columnNumber(colRange[0]);
+                endCol = columnNumber(colRange[1]);
+            }
+            QStringList rowRange = rowPart.split(':');
+            if (rowRange.size() == 2) {
+                startRow = rowRange[0].toInt();
+                endRow = rowRange[1].toInt();
+            }
+        }
+    } else if (trimmed.contains(':')) {
+        // 格式：A1:C10
+        QStringList parts = trimmed.split(':');
+        if (parts.size() == 2) {
+            QString startColPart;
+            QString startRowPart;
+            QString endColPart;
+            QString endRowPart;
+            if (splitCellRef(parts[0], startColPart, startRowPart) &&
+                splitCellRef(parts[1], endColPart, endRowPart)) {
+                startCol = columnNumber(startColPart);
+                endCol = columnNumber(endColPart);
+                startRow = startRowPart.toInt();
+                endRow = endRowPart.toInt();
+            }
+        }
+    }
+
+    if (startRow > endRow) {
+        std::swap(startRow, endRow);
+    }
+    if (startCol > endCol) {
+        std::swap(startCol, endCol);
+    }
+    return startRow > 0 && startCol > 0;
+}
+
+int XLSXDocument::columnNumber(const QString& col) {
+    return xlsxeditor::columnNumber(col);
+}
+
+QString XLSXDocument::columnName(int num) {
+    return xlsxeditor::columnName(num);
+}
+
+void XLSXDocument::loadAsync(const QString& filePath, const QString& sheetName,
+                             const QString& range) {
+    // 新的加载请求直接放弃在途加载，不等待其结束。
+    cancelLoad();
+    emit loadStarted(filePath);
+    reset(filePath, sheetName, range);
+
+    const quint64 generation = ++m_loadGeneration;
+    m_loadTraceStart = Tracer::isEnabled() ? Tracer::now() : -1;
+    auto* watcher = new LoadWatcher(this);
+    connect(watcher, &LoadWatcher::progressRangeChanged, this,
+            [this, watcher, generation](int, int maximum) {
+                if (generation == m_loadGeneration) {
+                    emit loadProgress(watcher->progressValue(), maximum);
+                }
+            });
+    connect(watcher, &LoadWatcher::progressValueChanged, this,
+            [this, watcher, generation](int value) {
+                if (generation == m_loadGeneration) {
+                    emit loadProgress(value, watcher->progressMaximum());
+                }
+            });
+    // 布局与图片批次随产出逐个接管；终结结果留到 finished 中处理。
+    connect(watcher, &LoadWatcher::resultsReadyAt, this,
+            [this, watcher, generation](int begin, int end) {
+                for (int i = begin; i < end && generation == m_loadGeneration; ++i) {
+                    adoptPartialResult(watcher->future().resultAt(i));
+                }
+            });
+    connect(watcher, &LoadWatcher::finished, this, [this, watcher, generation]() {
+        watcher->deleteLater();
+        // 已被取消或被新加载取代的结果直接丢弃。
+        if (generation != m_loadGeneration) {
+            return;
+        }
+        const QFuture<std::shared_ptr<LoadResult>> future = watcher->future();
+        m_loadFuture = QFuture<std::shared_ptr<LoadResult>>();
+        m_decodeQueue.reset();
+        adoptLoadResult(finalResult(future));
+    });
+
+    m_loadProfile = m_profilingEnabled ? std::make_shared<StageProfile>() : nullptr;
+    m_decodeQueue = std::make_shared<DecodeQueue>();
+    m_loadFuture = QtConcurrent::run(
+        runLoadJob, makeLoadRequest(m_filePath, m_sheetName, m_range, m_thumbnailCache,
+                                    m_loadProfile, m_decodeQueue, m_decodePictures));
+    watcher->setFuture(m_loadFuture);
+}
+
+bool XLSXDocument::load(const QString& filePath, const QString& sheetName,
+                        const QString& range) {
+    cancelLoad();
+    emit loadStarted(filePath);
+    reset(filePath, sheetName, range);
+    ++m_loadGeneration;
+    m_loadTraceStart = Tracer::isEnabled() ? Tracer::now() : -1;
+
+    // 加载任务直接在调用线程中执行，只有图片解码分派到解码线程池。
+    QPromise<std::shared_ptr<LoadResult>> promise;
+    QFuture<std::shared_ptr<LoadResult>> future = promise.future();
+    promise.start();
+    m_loadProfile = m_profilingEnabled ? std::make_shared<StageProfile>() : nullptr;
+    // 调用线程阻塞期间无人调整顺序，解码按锚点顺序进行。
+    runLoadJob(promise, makeLoadRequest(m_filePath, m_sheetName, m_range, m_thumbnailCache,
+                                        m_loadProfile, std::make_shared<DecodeQueue>(),
+                                        m_decodePictures));
+    promise.finish();
+    for (int i = 0; i < future.resultCount(); ++i) {
+        adoptPartialResult(future.resultAt(i));
+    }
+    return adoptLoadResult(finalResult(future));
+}
+
+void XLSXDocument::cancelLoad() {
+    if (m_loadFuture.isFinished()) {
+        return;
+    }
+    ++m_loadGeneration;
+    m_loadFuture.cancel();
+    m_loadFuture = QFuture<std::shared_ptr<LoadResult>>();
+    m_decodeQueue.reset();
+    emit loadCanceled(m_filePath);
+}
+
+bool XLSXDocument::isLoading() const {
+    return !m_loadFuture.isFinished();
+}
+
+void XLSXDocument::prioritizeDecode(const QVector<int>& indices) {
+    if (m_decodeQueue) {
+        m_decodeQueue->prioritize(indices);
+    }
+}
+
+void XLSXDocument::reset(const QString& filePath, const QString& sheetName,
+                         const QString& range) {
+    m_journal.close();
+    m_data.clear();
+    m_cells.clear();
+    m_indexByCell.clear();
+    m_rowIndex.clear();
+    m_colIndex.clear();
+    m_deletedCount = 0;
+    m_imageCache.clear();
+    m_pictureBytes = 0;
+    m_thumbnailBytes = 0;
+    m_cellBytes = 0;
+    m_package.reset();
+    m_lastError.clear();
+    m_filePath = filePath;
+    m_sheetName = sheetName;
+    m_range = range;
+}
+
+void XLSXDocument::adoptPartialResult(const std::shared_ptr<LoadResult>& result) {
+    if (result->kind == LoadResult::Kind::Layout) {
+        adoptLayout(*result);
+    } else if (result->kind == LoadResult::Kind::Pictures) {
+        adoptPictures(*result);
+    }
+}
+
+void XLSXDocument::adoptLayout(LoadResult& result) {
+    StageTimer timer(m_loadProfile.get(), "load.layout");
+    m_data = std::move(result.data);
+    m_cells = std::move(result.cells);
+    rebuildIndices();
+    if (m_journalEnabled) {
+        replayJournal(result.contentHash);
+    }
+    m_cellBytes = static_cast<qint64>(m_cells.byteSize());
+    timer.addItems(m_data.size());
+    timer.stop();
+    // 从发起加载到布局就绪即首屏时间，与图片数量无关。
+    if (m_loadTraceStart >= 0) {
+        Tracer::complete("load.firstScreen", m_loadTraceStart, Tracer::now() - m_loadTraceStart,
+                         m_filePath);
+    }
+    emit layoutReady(m_filePath, static_cast<int>(m_data.size()));
+}
+
+void XLSXDocument::adoptPictures(LoadResult& result) {
+    StageTimer timer(m_loadProfile.get(), "load.adoptPictures");
+    for (int i = 0; i < result.indices.size(); ++i) {
+        DataEntry& entry = m_data[result.indices[i]];
+        DecodedPicture& picture = result.pictures[i];
+        entry.bytes = std::move(picture.bytes);
+        entry.imageSize = picture.size;
+        entry.thumbnails = std::move(picture.thumbnails);
+        entry.pending = false;
+        m_pictureBytes += entry.bytes.size();
+        m_thumbnailBytes += entry.thumbnails.byteSize();
+    }
+    enforceMemoryBudget();
+    timer.addItems(result.indices.size());
+    timer.stop();
+    emit picturesReady(result.indices);
+}
+
+bool XLSXDocument::adoptLoadResult(const std::shared_ptr<LoadResult>& result) {
+    // 从发起到接管结果的整段加载，与工作线程中的 load.job 对照可看出排队与回调延迟。
+    if (m_loadTraceStart >= 0) {
+        Tracer::complete("load", m_loadTraceStart, Tracer::now() - m_loadTraceStart,
+                         m_filePath);
+        m_loadTraceStart = -1;
+    }
+    if (!result || !result->error.isEmpty()) {
+        m_lastError = result ? result->error
+                             : QCoreApplication::translate("XLSXEditor",
+                                                           "Failed to load XLSX data.");
+        publishTimings(QStringLiteral("load"), m_loadProfile, m_loadTimings);
+        emit loadFailed(m_filePath, m_lastError);
+        return false;
+    }
+
+    StageTimer timer(m_loadProfile.get(), "load.adopt");
+    m_package = std::move(result->package);
+    // 解码失败的项不再占位，行/列索引随之更新。
+    const bool anyFailed = std::any_of(m_data.cbegin(), m_data.cend(), [](const DataEntry& e) {
+        return !e.inGrid();
+    });
+    if (anyFailed) {
+        rebuildIndices();
+    }
+    enforceMemoryBudget();
+    timer.addItems(m_data.size());
+    timer.stop();
+    publishTimings(QStringLiteral("load"), m_loadProfile, m_loadTimings);
+    emit loadFinished(m_filePath, static_cast<int>(m_data.size()));
+    return true;
+}
+
+void XLSXDocument::publishTimings(const QString& operation,
+                                  const std::shared_ptr<StageProfile>& profile,
+                                  QVector<StageTiming>& timings) {
+    if (!profile) {
+        return;
+    }
+    timings = profile->timings();
+    emit stageTimingsReady(operation, timings);
+}
+
+void XLSXDocument::setImageCacheBudget(qint64 budgetBytes) {
+    m_imageCacheBudget = budgetBytes;
+    enforceMemoryBudget();
+}
+
+qint64 XLSXDocument::imageCacheBudget() const {
+    return m_imageCacheBudget;
+}
+
+void XLSXDocument::setMemoryBudget(qint64 budgetBytes) {
+    m_memoryBudget = std::max<qint64>(budgetBytes, 0);
+    enforceMemoryBudget();
+}
+
+void XLSXDocument::setViewMemory(qint64 iconBytes, qint64 previewBytes) {
+    m_iconBytes = iconBytes;
+    m_previewBytes = previewBytes;
+    enforceMemoryBudget();
+}
+
+MemoryUsage XLSXDocument::memoryUsage() const {
+    MemoryUsage usage;
+    usage.pictureBytes = m_pictureBytes;
+    usage.thumbnailBytes = m_thumbnailBytes;
+    usage.fullImageBytes = m_imageCache.usedBytes();
+    usage.cellBytes = m_cellBytes;
+    usage.iconBytes = m_iconBytes;
+    usage.previewBytes = m_previewBytes;
+    return usage;
+}
+
+void XLSXDocument::enforceMemoryBudget() {
+    if (m_memoryBudget <= 0) {
+        m_imageCache.setBudget(m_imageCacheBudget);
+        setIconCacheLimit(-1);
+        return;
+    }
+
+    // 全分辨率缓存只使用其余类别之外的预算余量；余量为零时不再保留解码结果，
+    // 预览仍可逐次解码。
+    const MemoryUsage usage = memoryUsage();
+    qint64 room = m_memoryBudget - (usage.total() - usage.fullImageBytes);
+    m_imageCache.setBudget(std::clamp<qint64>(room, 0, m_imageCacheBudget));
+
+    // 仍超出预算时释放常驻的压缩数据，需要时再从包中读取；缩略图始终保留。
+    for (auto it = m_data.begin(); room < 0 && m_package && it != m_data.end(); ++it) {
+        if (it->bytes.isEmpty()) {
+            continue;
+        }
+        room += it->bytes.size();
+        m_pictureBytes -= it->bytes.size();
+        it->bytes = QByteArray();
+    }
+
+    // 图标可随时由缩略图重新缩放，最后才收缩；图标增长占用的余量在下次检查时由全分辨率缓存让出。
+    setIconCacheLimit(std::max<qint64>(m_iconBytes + room, 0));
+    m_iconBytes = std::min(m_iconBytes, m_iconLimit);
+}
+
+void XLSXDocument::setIconCacheLimit(qint64 limitBytes) {
+    if (m_iconLimit == limitBytes) {
+        return;
+    }
+    m_iconLimit = limitBytes;
+    emit iconCacheLimitChanged(limitBytes);
+}
+
+void XLSXDocument::setThumbnailCacheBudget(qint64 budgetBytes) {
+    m_thumbnailCache.setBudget(budgetBytes);
+}
+
+qint64 XLSXDocument::thumbnailCacheBudget() const {
+    return m_thumbnailCache.budget();
+}
+
+int XLSXDocument::indexOf(int row, int col) const {
+    return m_indexByCell.value(cellKey(row, col), -1);
+}
+
+QString XLSXDocument::cellText(int row, int col) const {
+    if (row <= 0 || col <= 0) {
+        return QString();
+    }
+    return QString::fromStdString(m_cells.text(row, col)).trimmed();
+}
+
+QImage XLSXDocument::pictureAt(int row, int col) {
+    const int index = indexOf(row, col);
+    if (index < 0) {
+        return QImage();
+    }
+    const TraceSpan span("pictureAt");
+    DataEntry& entry = m_data[index];
+    // 缩略图来自磁盘缓存或压缩数据因内存预算被释放时，需要全分辨率时再从包中读取。
+    if (entry.bytes.isEmpty() && entry.inGrid() && m_package) {
+        std::string bytes;
+        if (m_package->archive().read(entry.mediaPath, bytes)) {
+            entry.bytes = QByteArray(bytes.data(), static_cast<qsizetype>(bytes.size()));
+            m_pictureBytes += entry.bytes.size();
+        }
+    }
+    const QImage image = m_imageCache.image(index, entry.bytes);
+    enforceMemoryBudget();
+    return image;
+}
+
+bool XLSXDocument::updateDeleted(int index, bool deleted) {
+    DataEntry& entry = m_data[index];
+    if (entry.deleted == deleted) {
+        return false;
+    }
+
+    entry.deleted = deleted;
+    const int delta = deleted ? 1 : -1;
+    m_deletedCount += delta;
+    if (entry.inGrid()) {
+        m_rowIndex[entry.row].deletedCount += delta;
+        m_colIndex[entry.col].deletedCount += delta;
+    }
+    journalEntry(index);
+    return true;
+}
+
+void XLSXDocument::setDeleted(int index, bool deleted) {
+    if (updateDeleted(index, deleted)) {
+        emit entryChanged(index);
+    }
+}
+
+void XLSXDocument::setDescription(int index, const QString& text) {
+    DataEntry& entry = m_data[index];
+    if (entry.desc == text) {
+        return;
+    }
+    entry.desc = text;
+    journalEntry(index);
+    emit entryChanged(index);
+}
+
+void XLSXDocument::setAllDeleted(bool deleted) {
+    bool changed = false;
+    for (int i = 0; i < m_data.size(); ++i) {
+        changed = updateDeleted(i, deleted) || changed;
+    }
+    if (changed) {
+        emit entriesChanged();
+    }
+}
+
+void XLSXDocument::toggleAxis(const QString& axis, int index) {
+    const QHash<int, AxisIndex>& axisIndex = axis == "row" ? m_rowIndex : m_colIndex;
+    auto it = axisIndex.constFind(index);
+    if (it == axisIndex.constEnd() || it->entries.isEmpty()) {
+        return;
+    }
+
+    // 全部保留时整行/列标记删除，否则全部恢复。
+    const bool nextDeleted = it->deletedCount == 0;
+    const QVector<int> entries = it->entries;
+    for (const int i : entries) {
+        updateDeleted(i, nextDeleted);
+    }
+    emit entriesChanged();
+}
+
+MarkColumns XLSXDocument::columns() const {
+    constexpr double kMissing = std::numeric_limits<double>::quiet_NaN();
+    const qsizetype n = m_data.size();
+    MarkColumns columns;
+    columns.row.resize(n);
+    columns.col.resize(n);
+    columns.desc.resize(n);
+    columns.value.resize(n);
+    columns.dose.resize(n);
+    columns.focus.resize(n);
+
+    // 同一行/列的表头只解析一次。
+    QHash<int, double> doseByCol;
+    QHash<int, double> focusByRow;
+    for (qsizetype i = 0; i < n; ++i) {
+        const DataEntry& entry = m_data[i];
+        columns.row[i] = entry.row;
+        columns.col[i] = entry.col;
+        columns.desc[i] = entry.desc;
+        columns.value[i] = MarkColumns::parseValue(entry.desc);
+
+        auto dose = doseByCol.constFind(entry.col);
+        if (dose == doseByCol.constEnd()) {
+            dose = doseByCol.insert(
+                entry.col, m_axisMapping.dose(cellText(2, entry.col)).value_or(kMissing));
+        }
+        columns.dose[i] = dose.value();
+        auto focus = focusByRow.constFind(entry.row);
+        if (focus == focusByRow.constEnd()) {
+            // 与界面一致：行表头为空时以行号作为表头。
+            QString header = cellText(entry.row, 1);
+            if (header.isEmpty()) {
+                header = QString::number(entry.row);
+            }
+            focus = focusByRow.insert(entry.row,
+                                      m_axisMapping.focus(header).value_or(kMissing));
+        }
+        columns.focus[i] = focus.value();
+    }
+    return columns;
+}
+
+QVector<int> XLSXDocument::matchRule(const MarkRule& rule) const {
+    const std::vector<char> mask = rule.evaluate(columns());
+    QVector<int> matched;
+    for (size_t i = 0; i < mask.size(); ++i) {
+        // 解码失败的项已不在网格中，不参与标记。
+        if (mask[i] && m_data[static_cast<qsizetype>(i)].inGrid()) {
+            matched.append(static_cast<int>(i));
+        }
+    }
+    return matched;
+}
+
+int XLSXDocument::applyRule(const MarkRule& rule, bool deleted) {
+    int changed = 0;
+    for (const int index : matchRule(rule)) {
+        changed += updateDeleted(index, deleted) ? 1 : 0;
+    }
+    if (changed > 0) {
+        emit entriesChanged();
+    }
+    return changed;
+}
+
+void XLSXDocument::journalEntry(int index) {
+    const DataEntry& entry = m_data[index];
+    m_journal.append({entry.row, entry.col, entry.deleted, entry.desc});
+}
+
+void XLSXDocument::replayJournal(const QByteArray& contentHash) {
+    int startRow = 0;
+    int startCol = 0;
+    int endRow = 0;
+    int endCol = 0;
+    parseRange(m_range, startRow, startCol, endRow, endCol);
+    const QString scope = QStringLiteral("%1!%2:%3:%4:%5")
+                              .arg(m_sheetName)
+                              .arg(startRow)
+                              .arg(startCol)
+                              .arg(endRow)
+                              .arg(endCol);
+    const QString path = MarkJournal::pathFor(m_filePath, scope);
+
+    // 回放时日志尚未开始记录，恢复状态不会重复追加；网格此时尚未建立，无需通知。
+    for (const auto& record : MarkJournal::read(path, contentHash)) {
+        const int index = indexOf(record.row, record.col);
+        if (index < 0) {
+            continue;
+        }
+        updateDeleted(index, record.deleted);
+        DataEntry& entry = m_data[index];
+        if (entry.desc != record.desc) {
+            entry.desc = record.desc;
+        }
+    }
+
+    QVector<MarkJournal::Record> snapshot;
+    for (const auto& entry : std::as_const(m_data)) {
+        if (entry.deleted || entry.desc != entry.origDesc) {
+            snapshot.append({entry.row, entry.col, entry.deleted, entry.desc});
+        }
+    }
+    m_journal.start(path, contentHash, snapshot);
+}
+
+void XLSXDocument::rebuildIndices() {
+    m_indexByCell.clear();
+    m_indexByCell.reserve(m_data.size());
+    m_rowIndex.clear();
+    m_colIndex.clear();
+    m_deletedCount = 0;
+    for (int i = 0; i < m_data.size(); ++i) {
+        const DataEntry& entry = m_data[i];
+        m_indexByCell.insert(cellKey(entry.row, entry.col), i);
+        const int deleted = entry.deleted ? 1 : 0;
+        m_deletedCount += deleted;
+        // 表头批量切换只作用于网格中显示的项
+        if (!entry.inGrid()) {
+            continue;
+        }
+        AxisIndex& row = m_rowIndex[entry.row];
+        row.entries.append(i);
+        row.deletedCount += deleted;
+        AxisIndex& col = m_colIndex[entry.col];
+        col.entries.append(i);
+        col.deletedCount += deleted;
+    }
+}
+
+QString XLSXDocument::saveTargetPath() const {
+    if (m_filePath.isEmpty()) {
+        return QString();
+    }
+    return saveTargetPathFor(m_filePath);
+}
+
+QString XLSXDocument::saveTargetPathFor(const QString& sourcePath) {
+    const QFileInfo sourceInfo(sourcePath);
+    return sourceInfo.absoluteDir().filePath(QStringLiteral("filtered/") + sourceInfo.fileName());
+}
+
+bool XLSXDocument::checkCanSave() {
+    if (isLoading()) {
+        m_lastError =
+            QCoreApplication::translate("XLSXEditor", "Cannot save while the workbook is loading.");
+        return false;
+    }
+    if (m_data.isEmpty()) {
+        m_lastError = QCoreApplication::translate("XLSXEditor", "No data to save.");
+        return false;
+    }
+    return true;
+}
+
+QString XLSXDocument::prepareSaveTargetPath() {
+    const QString targetPath = saveTargetPath();
+    if (targetPath.isEmpty()) {
+        m_lastError = QCoreApplication::translate("XLSXEditor", "No workbook is loaded.");
+        return QString();
+    }
+    const QString filteredDirPath = QFileInfo(targetPath).absolutePath();
+    if (!QDir().mkpath(filteredDirPath)) {
+        qWarning() << "Failed to create filtered folder:" << filteredDirPath;
+        m_lastError =
+            QCoreApplication::translate("XLSXEditor", "Failed to create filtered folder: %1")
+                .arg(filteredDirPath);
+        return QString();
+    }
+    return targetPath;
+}
+
+bool XLSXDocument::saveAsync() {
+    if (!checkCanSave()) {
+        return false;
+    }
+    // 保存进行中时合并为一次：结束后以最新状态再保存一次。
+    if (isSaving()) {
+        m_savePending = true;
+        return true;
+    }
+    return startSave();
+}
+
+bool XLSXDocument::save() {
+    if (!checkCanSave()) {
+        return false;
+    }
+    if (isSaving()) {
+        m_lastError = QCoreApplication::translate("XLSXEditor", "A save is already in progress.");
+        return false;
+    }
+    m_saveProfile = m_profilingEnabled ? std::make_shared<StageProfile>() : nullptr;
+    StageTimer prepareTimer(m_saveProfile.get(), "save.prepare");
+    const QString targetPath = prepareSaveTargetPath();
+    if (targetPath.isEmpty()) {
+        return false;
+    }
+    prepareTimer.stop();
+    emit saveStarted(targetPath);
+
+    QPromise<bool> promise;
+    QFuture<bool> future = promise.future();
+    promise.start();
+    runSaveJob(promise, makeSaveRequest(m_filePath, targetPath, m_sheetName, m_dryRun, m_data,
+                                        m_saveProfile));
+    promise.finish();
+    const bool ok = future.resultCount() > 0 && future.result();
+    finishSave(targetPath, ok);
+    return ok;
+}
+
+bool XLSXDocument::isSaving() const {
+    return !m_saveFuture.isFinished();
+}
+
+bool XLSXDocument::startSave() {
+    m_saveProfile = m_profilingEnabled ? std::make_shared<StageProfile>() : nullptr;
+    StageTimer prepareTimer(m_saveProfile.get(), "save.prepare");
+    const QString targetPath = prepareSaveTargetPath();
+    if (targetPath.isEmpty()) {
+        return false;
+    }
+    prepareTimer.stop();
+
+    auto* watcher = new SaveWatcher(this);
+    connect(watcher, &SaveWatcher::progressValueChanged, this, [this, watcher](int value) {
+        emit saveProgress(value, watcher->progressMaximum());
+    });
+    connect(watcher, &SaveWatcher::finished, this, [this, watcher, targetPath]() {
+        watcher->deleteLater();
+        const QFuture<bool> future = watcher->future();
+        m_saveFuture = QFuture<bool>();
+        finishSave(targetPath, future.resultCount() > 0 && future.result());
+    });
+
+    emit saveStarted(targetPath);
+    m_saveFuture = QtConcurrent::run(runSaveJob, makeSaveRequest(m_filePath, targetPath,
+                                                                 m_sheetName, m_dryRun, m_data,
+                                                                 m_saveProfile));
+    watcher->setFuture(m_saveFuture);
+    return true;
+}
+
+void XLSXDocument::finishSave(const QString& targetPath, bool ok) {
+    if (!ok) {
+        m_lastError = QCoreApplication::translate("XLSXEditor", "Failed to save data to XLSX.");
+    }
+    publishTimings(QStringLiteral("save"), m_saveProfile, m_saveTimings);
+    emit saveFinished(targetPath, ok);
+
+    // 被合并的保存请求以最新状态重新保存；无法发起时同样以失败结束。
+    if (std::exchange(m_savePending, false) && !startSave()) {
+        emit saveFinished(targetPath, false);
+    }
+}
+
+}  // namespace cc::neolux::fem::xlsxeditor
@@ -1,94 +1,30 @@
 #include "cc/neolux/fem/xlsxeditor/XLSXEditor.hpp"
 
-#include <QCheckBox>
 #include <QCoreApplication>
 #include <QCursor>
-#include <QDebug>
-#include <QDialog>
-#include <QDir>
 #include <QEvent>
-#include <QFile>
-#include <QFileInfo>
-#include <QGridLayout>
-#include <QLabel>
-#include <QLocale>
+#include <QEventLoop>
 #include <QMessageBox>
 #include <QMouseEvent>
-#include <QPainter>
 #include <QPixmap>
 #include <QProgressBar>
+#include <QScrollBar>
+#include <QSet>
 #include <QSettings>
 #include <QTimer>
-#include <QVBoxLayout>
 #include <QWheelEvent>
 #include <algorithm>
 #include <cmath>
-#include <filesystem>
-#include <fstream>
+#include <memory>
 #include <optional>
-#include <pugixml.hpp>
-#include <set>
-#include <unordered_set>
 #include <utility>
 
-#include "cc/neolux/fem/xlsxeditor/DataItem.hpp"
-#include "cc/neolux/utils/KFZippa/kfzippa.hpp"
+#include "cc/neolux/fem/xlsxeditor/DataGridWidget.hpp"
 #include "ui_XLSXEditor.h"
 
 namespace {
-constexpr int kBaseItemWidth = 70;
-constexpr int kBaseItemHeight = 90;
-constexpr int kBaseHeaderColWidth = 90;
-constexpr int kBaseHeaderRowHeight = 24;
-constexpr int kGridSpacing = 0;
 constexpr bool kEnableSaveProgress = true;
 
-bool splitCellRef(const QString& ref, QString& colPart, QString& rowPart) {
-    colPart.clear();
-    rowPart.clear();
-    for (QChar c : ref.trimmed()) {
-        if (c.isLetter()) {
-            colPart.append(c.toUpper());
-        } else if (c.isDigit()) {
-            rowPart.append(c);
-        }
-    }
-    return !colPart.isEmpty() && !rowPart.isEmpty();
-}
-
-class AxisCornerWidget : public QWidget {
-public:
-    explicit AxisCornerWidget(QWidget* parent = nullptr) : QWidget(parent) {}
-
-protected:
-    void paintEvent(QPaintEvent* event) override {
-        QWidget::paintEvent(event);
-        QPainter painter(this);
-        painter.fillRect(rect(), palette().window());
-        painter.setPen(palette().mid().color());
-        painter.drawRect(rect().adjusted(0, 0, -1, -1));
-        painter.setPen(palette().text().color());
-        painter.drawLine(0, 0, width() - 1, height() - 1);
-        painter.drawText(QRect(4, height() / 2, width() / 2 - 6, height() / 2),
-                         Qt::AlignLeft | Qt::AlignBottom, "Focus");
-        painter.drawText(QRect(width() / 2, 2, width() / 2 - 4, height() / 2 - 4),
-                         Qt::AlignRight | Qt::AlignTop, "Dose");
-    }
-};
-
-std::optional<double> parseHeaderNumber(const QString& headerText) {
-    const QString text = headerText.trimmed();
-    if (text.isEmpty()) {
-        return std::nullopt;
-    }
-    bool ok = false;
-    const double value = QLocale::c().toDouble(text, &ok);
-    if (!ok) {
-        return std::nullopt;
-    }
-    return value;
-}
-
 QString formatAxisValue(double value) {
     QString text = QString::number(value, 'f', 6);
     while (text.contains('.') && (text.endsWith('0') || text.endsWith('.'))) {
@@ -101,14 +37,9 @@ QString formatAxisValue(double value) {
     return text;
 }
 
-QString buildAxisValueText(const QString& headerText, double center, double step, bool isDose) {
-    auto headerValue = parseHeaderNumber(headerText);
-    if (!headerValue.has_value()) {
-        return headerText;
-    }
-    const double axisValue =
-        isDose ? (center + headerValue.value() * step) : (center - headerValue.value() * step);
-    return formatAxisValue(axisValue);
+/** @brief 表头映射后的数值文本，表头非数值时保留原文。 */
+QString buildAxisValueText(const QString& headerText, std::optional<double> axisValue) {
+    return axisValue ? formatAxisValue(*axisValue) : headerText;
 }
 }  // namespace
 
@@ -117,18 +48,14 @@ using namespace cc::neolux::fem::xlsxeditor;
 XLSXEditor::XLSXEditor(QWidget* parent, bool dry_run)
     : QWidget(parent),
       ui(new Ui::XLSXEditor),
-      m_wrapper(nullptr),
-      m_sheetIndex(-1),
+      m_document(new XLSXDocument(this, dry_run)),
+      m_notifySaveResult(false),
       m_enableSaveProgress(kEnableSaveProgress),
-      m_dryRun(dry_run),
+      m_asyncLoad(false),
       m_previewOnly(false),
       m_itemScale(1.0),
       m_syncingSelectAll(false),
-      m_axisHeaderConfigEnabled(false),
-      m_doseCenter(0.0),
-      m_doseStep(0.0),
-      m_focusCenter(0.0),
-      m_focusStep(0.0),
+      m_gridEntryCount(0),
       m_hoverPreview(nullptr),
       m_hoverRow(-1),
       m_hoverCol(-1),
@@ -153,10 +80,9 @@ XLSXEditor::XLSXEditor(QWidget* parent, bool dry_run)
         }
 
         if (!inValidRange && m_hoverRow >= 0 && m_hoverCol >= 0) {
-            auto it = m_itemByCell.find(cellKey(m_hoverRow, m_hoverCol));
-            if (it != m_itemByCell.end() && it.value() != nullptr) {
-                DataItem* anchor = it.value();
-                const QRect imageRectGlobal = anchor->imageWidgetGlobalRect();
+            const int index = m_document->indexOf(m_hoverRow, m_hoverCol);
+            if (index >= 0) {
+                const QRect imageRectGlobal = ui->dataGrid->imageGlobalRect(index);
                 if (imageRectGlobal.isValid() && imageRectGlobal.contains(cursorPos)) {
                     inValidRange = true;
                 }
@@ -171,8 +97,10 @@ XLSXEditor::XLSXEditor(QWidget* parent, bool dry_run)
         if (m_hoverPreview) {
             m_hoverPreview->hide();
         }
+        m_hoverOrigImage = QImage();
         m_hoverRow = -1;
         m_hoverCol = -1;
+        reportViewMemory();
     });
     // 读取持久化的预览尺寸（如果有）
     QSettings settings;
@@ -180,300 +108,270 @@ XLSXEditor::XLSXEditor(QWidget* parent, bool dry_run)
     if (v.isValid() && v.canConvert<QSize>()) {
         m_savedHoverPreviewSize = v.toSize();
     }
+    // 数据项网格的交互统一转交文档处理，网格本身不修改数据。
+    connect(ui->dataGrid, &DataGridWidget::toggleRequested, this, [this](int index) {
+        m_document->setDeleted(index, !m_document->entries()[index].deleted);
+        syncSelectAllState();
+    });
+    connect(ui->dataGrid, &DataGridWidget::descriptionEdited, m_document,
+            &XLSXDocument::setDescription);
+    connect(ui->dataGrid, &DataGridWidget::imagePreviewRequested, this,
+            &XLSXEditor::showHoverPreview);
+    connect(ui->dataGrid, &DataGridWidget::headerDoubleClicked, m_document,
+            &XLSXDocument::toggleAxis);
+
+    // 文档状态变化同步到界面；先处理界面，再转发给宿主。
+    connect(m_document, &XLSXDocument::entryChanged, ui->dataGrid,
+            &DataGridWidget::refreshEntry);
+    // 批量修改只整体重绘一次网格。
+    connect(m_document, &XLSXDocument::entriesChanged, this, [this]() {
+        ui->dataGrid->update();
+        syncSelectAllState();
+    });
+    connect(m_document, &XLSXDocument::loadStarted, this, [this]() {
+        // 文档随后清空数据，网格须先释放对数据项的引用。
+        resetState();
+        ui->progressBar->setRange(0, 0);
+        ui->progressBar->setValue(0);
+        ui->progressBar->setVisible(true);
+    });
+    connect(m_document, &XLSXDocument::loadProgress, this, [this](int value, int maximum) {
+        ui->progressBar->setRange(0, maximum);
+        ui->progressBar->setValue(value);
+    });
+    // 布局就绪即建立网格，进度条保留到全部图片解码完成；图片逐批到达时只重绘对应单元格。
+    connect(m_document, &XLSXDocument::layoutReady, this, [this]() {
+        displayData(false);
+        prioritizeVisibleDecode();
+    });
+    // 滚动时解码顺序跟随视口。
+    connect(ui->scrollArea->horizontalScrollBar(), &QScrollBar::valueChanged, this,
+            &XLSXEditor::prioritizeVisibleDecode);
+    connect(ui->scrollArea->verticalScrollBar(), &QScrollBar::valueChanged, this,
+            &XLSXEditor::prioritizeVisibleDecode);
+    // 内存预算在最后一级收缩图标缓存。
+    connect(m_document, &XLSXDocument::iconCacheLimitChanged, ui->dataGrid,
+            &DataGridWidget::setIconCacheLimit);
+    connect(m_document, &XLSXDocument::picturesReady, this, [this](const QVector<int>& indices) {
+        for (const int index : indices) {
+            ui->dataGrid->refreshEntry(index);
+        }
+    });
+    connect(m_document, &XLSXDocument::loadFinished, this, [this]() {
+        ui->progressBar->setVisible(false);
+        // 只有解码失败的项需要从网格中移除时才重建，避免打断加载期间的浏览与编辑。
+        const QVector<DataEntry>& data = m_document->entries();
+        const auto shown = std::count_if(data.cbegin(), data.cend(),
+                                         [](const DataEntry& entry) { return entry.inGrid(); });
+        if (shown != m_gridEntryCount) {
+            // 加载期间用户可能已切换预览模式或滚动，重建时保持显示状态。
+            const int scrollX = ui->scrollArea->horizontalScrollBar()->value();
+            const int scrollY = ui->scrollArea->verticalScrollBar()->value();
+            displayData(m_previewOnly);
+            ui->scrollArea->horizontalScrollBar()->setValue(scrollX);
+            ui->scrollArea->verticalScrollBar()->setValue(scrollY);
+        }
+        reportViewMemory();
+    });
+    connect(m_document, &XLSXDocument::loadFailed, this,
+            [this](const QString&, const QString& message) { handleLoadFailed(message); });
+    connect(m_document, &XLSXDocument::loadCanceled, ui->progressBar, &QProgressBar::hide);
+    connect(m_document, &XLSXDocument::saveStarted, this, &XLSXEditor::beginSaveProgress);
+    connect(m_document, &XLSXDocument::saveProgress, this, [this](int value, int maximum) {
+        if (m_enableSaveProgress && !isLoading()) {
+            ui->progressBar->setRange(0, maximum);
+            ui->progressBar->setValue(value);
+        }
+    });
+    connect(m_document, &XLSXDocument::saveFinished, this, &XLSXEditor::handleSaveFinished);
+    connect(m_document, &XLSXDocument::loadStarted, this, &XLSXEditor::loadStarted);
+    connect(m_document, &XLSXDocument::loadProgress, this, &XLSXEditor::loadProgress);
+    connect(m_document, &XLSXDocument::loadFinished, this, &XLSXEditor::loadFinished);
+    connect(m_document, &XLSXDocument::loadFailed, this, &XLSXEditor::loadFailed);
+    connect(m_document, &XLSXDocument::saveProgress, this, &XLSXEditor::saveProgress);
+    connect(m_document, &XLSXDocument::saveFinished, this, &XLSXEditor::saveFinished);
+    connect(m_document, &XLSXDocument::stageTimingsReady, this,
+            &XLSXEditor::stageTimingsReady);
     syncPreviewButtonText();
 }
 
-QString XLSXEditor::cellKey(int row, int col) const {
-    return QString::number(row) + QLatin1Char(':') + QString::number(col);
-}
-
 XLSXEditor::~XLSXEditor() {
-    clearDataItems();
+    // 文档先于界面析构：放弃在途加载并等待在途保存，不再回调已释放的界面。
+    m_document->disconnect(this);
+    delete m_document;
+    // 子组件随后析构时滚动条与视口仍可能回调 prioritizeVisibleDecode。
+    m_document = nullptr;
     delete ui;
-    if (m_wrapper) {
-        m_wrapper->close();
-        delete m_wrapper;
-    }
-    if (m_pictureReader.isOpen()) {
-        m_pictureReader.close();
-    }
 }
 
 void XLSXEditor::loadXLSX(const QString& filePath, const QString& sheetName, const QString& range) {
-    resetState();
-    m_filePath = filePath;
-    m_sheetName = sheetName;
-    m_range = range;
-
-    m_wrapper = new cc::neolux::utils::MiniXLSX::OpenXLSXWrapper();
-    if (!m_wrapper->open(filePath.toStdString())) {
-        QMessageBox::critical(
-            this, QCoreApplication::translate("XLSXEditor", "Error"),
-            QCoreApplication::translate("XLSXEditor", "Failed to open XLSX file."));
-        ui->progressBar->setVisible(false);
+    const TraceSpan span("loadXLSX", filePath);
+    m_document->loadAsync(filePath, sheetName, range);
+    if (m_asyncLoad || !m_document->isLoading()) {
         return;
     }
 
-    if (!m_pictureReader.open(filePath.toStdString())) {
-        QMessageBox::critical(
-            this, QCoreApplication::translate("XLSXEditor", "Error"),
-            QCoreApplication::translate("XLSXEditor", "Failed to prepare picture reader."));
-        m_wrapper->close();
-        ui->progressBar->setVisible(false);
-        return;
-    }
+    // 同步模式：在局部事件循环中等待完成，期间屏蔽用户输入，避免重入半构建的数据。
+    QEventLoop loop;
+    connect(m_document, &XLSXDocument::loadFinished, &loop, &QEventLoop::quit);
+    connect(m_document, &XLSXDocument::loadFailed, &loop, &QEventLoop::quit);
+    connect(m_document, &XLSXDocument::loadCanceled, &loop, &QEventLoop::quit);
+    loop.exec(QEventLoop::ExcludeUserInputEvents);
+}
 
-    // 查找表索引
-    m_sheetIndex = -1;
-    for (unsigned int i = 0; i < m_wrapper->sheetCount(); ++i) {
-        if (m_wrapper->sheetName(i) == sheetName.toStdString()) {
-            m_sheetIndex = static_cast<int>(i);
-            break;
-        }
-    }
-    if (m_sheetIndex < 0) {
-        QMessageBox::critical(
-            this, QCoreApplication::translate("XLSXEditor", "Error"),
-            QCoreApplication::translate("XLSXEditor", "Sheet not found: %1").arg(sheetName));
-        ui->progressBar->setVisible(false);
-        return;
-    }
+void XLSXEditor::cancelLoad() {
+    m_document->cancelLoad();
+}
 
-    // 计算总单元格数
-    int startRow, startCol, endRow, endCol;
-    parseRange(m_range, startRow, startCol, endRow, endCol);
-    int totalCells = (endRow - startRow + 1) * (endCol - startCol + 1);
+bool XLSXEditor::isLoading() const {
+    return m_document->isLoading();
+}
 
-    ui->progressBar->setMinimum(0);
-    ui->progressBar->setMaximum(totalCells);
-    ui->progressBar->setValue(0);
-    ui->progressBar->setVisible(true);
-    QCoreApplication::processEvents();
+void XLSXEditor::setAsyncLoad(bool async) {
+    m_asyncLoad = async;
+}
 
-    loadData(*ui->progressBar);
-    displayData(false);
+bool XLSXEditor::isAsyncLoad() const {
+    return m_asyncLoad;
+}
+
+void XLSXEditor::handleLoadFailed(const QString& message) {
     ui->progressBar->setVisible(false);
+    // 异步模式由宿主通过 loadFailed 自行决定如何提示。
+    if (!m_asyncLoad) {
+        QMessageBox::critical(this, QCoreApplication::translate("XLSXEditor", "Error"), message);
+    }
 }
 
 void XLSXEditor::setDryRun(bool dry_run) {
-    m_dryRun = dry_run;
+    m_document->setDryRun(dry_run);
 }
 
 bool XLSXEditor::isDryRun() const {
-    return m_dryRun;
+    return m_document->isDryRun();
 }
 
 void XLSXEditor::setAxisHeaderConfig(double doseCenter, double doseStep, double focusCenter,
                                      double focusStep) {
-    m_axisHeaderConfigEnabled = true;
-    m_doseCenter = doseCenter;
-    m_doseStep = doseStep;
-    m_focusCenter = focusCenter;
-    m_focusStep = focusStep;
+    m_document->setAxisMapping({true, doseCenter, doseStep, focusCenter, focusStep});
 }
 
-void XLSXEditor::parseRange(const QString& range, int& startRow, int& startCol, int& endRow,
-                            int& endCol) {
-    startRow = 0;
-    startCol = 0;
-    endRow = 0;
-    endCol = 0;
-
-    QString trimmed = range.trimmed();
-    if (trimmed.contains(',')) {
-        // 格式：A:C,1:10
-        QStringList parts = trimmed.split(',');
-        if (parts.size() == 2) {
-            QString colPart = parts[0];
-            QString rowPart = parts[1];
-            QStringList colRange = colPart.split(':');
-            if (colRange.size() == 2) {
-                startCol = colToNum(colRange[0]);
-                endCol = colToNum(colRange[1]);
-            }
-            QStringList rowRange = rowPart.split(':');
-            if (rowRange.size() == 2) {
-                startRow = rowRange[0].toInt();
-                endRow = rowRange[1].toInt();
-            }
-        }
-    } else if (trimmed.contains(':')) {
-        // 格式：A1:C10
-        QStringList parts = trimmed.split(':');
-        if (parts.size() == 2) {
-            QString startColPart;
-            QString startRowPart;
-            QString endColPart;
-            QString endRowPart;
-            if (splitCellRef(parts[0], startColPart, startRowPart) &&
-                splitCellRef(parts[1], endColPart, endRowPart)) {
-                startCol = colToNum(startColPart);
-                endCol = colToNum(endColPart);
-                startRow = startRowPart.toInt();
-                endRow = endRowPart.toInt();
-            }
-        }
-    }
+void XLSXEditor::setProfilingEnabled(bool enabled) {
+    m_document->setProfilingEnabled(enabled);
+}
 
-    if (startRow > endRow) {
-        std::swap(startRow, endRow);
-    }
-    if (startCol > endCol) {
-        std::swap(startCol, endCol);
-    }
+bool XLSXEditor::isProfilingEnabled() const {
+    return m_document->isProfilingEnabled();
 }
 
-int XLSXEditor::colToNum(const QString& col) {
-    int num = 0;
-    for (QChar c : col) {
-        num = num * 26 + (c.toUpper().unicode() - 'A' + 1);
-    }
-    return num;
+const QVector<StageTiming>& XLSXEditor::lastLoadTimings() const {
+    return m_document->lastLoadTimings();
 }
 
-QString XLSXEditor::numToCol(int num) {
-    QString col;
-    while (num > 0) {
-        num--;
-        col.prepend(QChar('A' + (num % 26)));
-        num /= 26;
-    }
-    return col;
+const QVector<StageTiming>& XLSXEditor::lastSaveTimings() const {
+    return m_document->lastSaveTimings();
 }
 
-QString XLSXEditor::readCellText(int row, int col) {
-    if (row <= 0 || col <= 0 || m_wrapper == nullptr || m_sheetIndex < 0) {
-        return "";
-    }
+void XLSXEditor::startTrace() {
+    Tracer::start();
+}
 
-    const QString cell = numToCol(col) + QString::number(row);
-    auto cellOpt =
-        m_wrapper->getCellValue(static_cast<unsigned int>(m_sheetIndex), cell.toStdString());
-    return cellOpt.has_value() ? QString::fromStdString(cellOpt.value()).trimmed() : "";
+bool XLSXEditor::stopTrace(const QString& path) {
+    return Tracer::stop(path);
 }
 
-void XLSXEditor::loadData(QProgressBar& progressBar) {
-    m_data.clear();
-    m_indexByCell.clear();
-    m_itemByCell.clear();
-    m_dirtyCells.clear();
-    int startRow, startCol, endRow, endCol;
-    parseRange(m_range, startRow, startCol, endRow, endCol);
-
-    // 通过图片读取器获取表内图片
-    auto allPictures = m_pictureReader.getSheetPictures(static_cast<unsigned int>(m_sheetIndex));
-    std::string tempDir = m_pictureReader.getTempDir();
-    if (tempDir.empty()) {
-        qWarning() << "Failed to extract XLSX temporary files.";
-        progressBar.setVisible(false);
-        return;
-    }
+void XLSXEditor::setImageCacheBudget(qint64 budgetBytes) {
+    m_document->setImageCacheBudget(budgetBytes);
+}
 
-    int totalPictures = 0;
-    for (const auto& pic : allPictures) {
-        if (pic.rowNum >= startRow && pic.rowNum <= endRow && pic.colNum >= startCol &&
-            pic.colNum <= endCol) {
-            ++totalPictures;
-        }
-    }
-    progressBar.setMaximum(totalPictures);
+qint64 XLSXEditor::imageCacheBudget() const {
+    return m_document->imageCacheBudget();
+}
 
-    int current = 0;
-    for (const auto& pic : allPictures) {
-        if (pic.rowNum < startRow || pic.rowNum > endRow || pic.colNum < startCol ||
-            pic.colNum > endCol) {
-            continue;
-        }
+void XLSXEditor::setMemoryBudget(qint64 budgetBytes) {
+    m_document->setMemoryBudget(budgetBytes);
+}
 
-        progressBar.setValue(++current);
-        QCoreApplication::processEvents();
-
-        QImage image;
-        const QString tempDirQ = QString::fromStdString(tempDir);
-        QDir rootDir(tempDirQ);
-        const QString imagePath =
-            rootDir.filePath(QStringLiteral("xl/") + QString::fromStdString(pic.relativePath));
-        // qInfo() << "Loading image from" << imagePath;
-
-        QFile qfile(imagePath);
-        if (qfile.open(QIODevice::ReadOnly)) {
-            const QByteArray bytes = qfile.readAll();
-            image = QImage::fromData(bytes);
-            if (image.isNull()) {
-                qWarning() << "Failed to load image from" << imagePath;
-            }
-            qfile.close();
-        } else {
-            qWarning() << "Image file not found:" << imagePath;
-        }
+qint64 XLSXEditor::memoryBudget() const {
+    return m_document->memoryBudget();
+}
 
-        const QString value = readCellText(pic.rowNum + 1, pic.colNum);
-        m_data.append({pic.rowNum, pic.colNum, image, value, false});
-        m_indexByCell.insert(cellKey(pic.rowNum, pic.colNum), m_data.size() - 1);
-    }
+MemoryUsage XLSXEditor::memoryUsage() const {
+    // 图标在绘制时按需生成，查询时取视图的当前值；只读，预算在数据变化时才检查。
+    MemoryUsage usage = m_document->memoryUsage();
+    usage.iconBytes = ui ? ui->dataGrid->iconCacheBytes() : 0;
+    usage.previewBytes = previewMemory();
+    return usage;
+}
+
+void XLSXEditor::setThumbnailCacheBudget(qint64 budgetBytes) {
+    m_document->setThumbnailCacheBudget(budgetBytes);
+}
+
+qint64 XLSXEditor::thumbnailCacheBudget() const {
+    return m_document->thumbnailCacheBudget();
+}
+
+int XLSXEditor::applyMarkRule(const QString& expression, bool deleted, QString* error) {
+    const std::optional<MarkRule> rule = MarkRule::compile(expression, error);
+    return rule ? m_document->applyRule(*rule, deleted) : -1;
+}
+
+QImage XLSXEditor::pictureAt(int row, int col) {
+    return m_document->pictureAt(row, col);
 }
 
 void XLSXEditor::clearDataItems() {
     if (!ui) {
         return;
     }
-    for (auto item : m_dataItems) {
-        ui->gridData->removeWidget(item);
-        delete item;
-    }
-    for (auto widget : m_headerWidgets) {
-        ui->gridData->removeWidget(widget);
-        delete widget;
-    }
-    m_dataItems.clear();
-    m_headerWidgets.clear();
-    m_itemByCell.clear();
+    ui->dataGrid->clear();
 }
 
 void XLSXEditor::resetState() {
     clearDataItems();
-    m_data.clear();
-    m_indexByCell.clear();
-    m_dirtyCells.clear();
+    if (m_hoverPreview) {
+        m_hoverPreview->hide();
+    }
+    m_hoverOrigImage = QImage();
+    m_hoverRow = -1;
+    m_hoverCol = -1;
     m_previewOnly = false;
     m_itemScale = 1.0;
-    m_sheetIndex = -1;
-    if (m_wrapper) {
-        m_wrapper->close();
-        delete m_wrapper;
-        m_wrapper = nullptr;
-    }
-    if (m_pictureReader.isOpen()) {
-        m_pictureReader.close();
-    }
+    m_gridEntryCount = 0;
     if (ui && ui->progressBar) {
         ui->progressBar->setValue(0);
         ui->progressBar->setVisible(false);
     }
     syncPreviewButtonText();
     syncSelectAllState();
+    reportViewMemory();
 }
 
 void XLSXEditor::displayData(bool previewOnly) {
+    const TraceSpan span("displayData");
+    std::unique_ptr<StageProfile> profile;
+    if (m_document->isProfilingEnabled()) {
+        profile = std::make_unique<StageProfile>();
+    }
+
+    StageTimer clearTimer(profile.get(), "display.clear");
     m_previewOnly = previewOnly;
     syncPreviewButtonText();
-    // 清理旧组件
     clearDataItems();
+    clearTimer.stop();
 
-    int startRow, startCol, endRow, endCol;
-    parseRange(m_range, startRow, startCol, endRow, endCol);
-
-    QGridLayout* layout = ui->gridData;
-    layout->setSpacing(kGridSpacing);
-    layout->setContentsMargins(0, 0, 0, 0);
-    layout->setAlignment(Qt::AlignTop | Qt::AlignLeft);
-
+    StageTimer axesTimer(profile.get(), "display.axes");
+    const QVector<DataEntry>& data = m_document->entries();
+    const AxisMapping& mapping = m_document->axisMapping();
     QSet<int> rowSet;
     QSet<int> colSet;
-    for (const auto& entry : std::as_const(m_data)) {
-        if (!entry.image.isNull()) {
+    m_gridEntryCount = 0;
+    for (const auto& entry : data) {
+        if (entry.inGrid()) {
             rowSet.insert(entry.row);
             colSet.insert(entry.col);
+            ++m_gridEntryCount;
         }
     }
     QVector<int> displayRows = rowSet.values();
@@ -481,174 +379,61 @@ void XLSXEditor::displayData(bool previewOnly) {
     std::sort(displayRows.begin(), displayRows.end());
     std::sort(displayCols.begin(), displayCols.end());
 
-    QHash<int, int> rowToGridRow;
-    QHash<int, int> colToGridCol;
-    const int headerLayers = m_axisHeaderConfigEnabled ? 2 : 1;
-    for (int i = 0; i < displayRows.size(); ++i) {
-        rowToGridRow.insert(displayRows[i], i + headerLayers);
-    }
-    for (int i = 0; i < displayCols.size(); ++i) {
-        colToGridCol.insert(displayCols[i], i + headerLayers);
-    }
-
-    const int headerWidth = static_cast<int>(std::round(kBaseHeaderColWidth * m_itemScale));
-    const int headerHeight = static_cast<int>(std::round(kBaseHeaderRowHeight * m_itemScale));
-    const int focusInnerHeaderWidth =
-        m_axisHeaderConfigEnabled
-            ? static_cast<int>(std::round(kBaseHeaderColWidth * 0.65 * m_itemScale))
-            : headerWidth;
-
-    if (m_axisHeaderConfigEnabled) {
-        AxisCornerWidget* corner = new AxisCornerWidget(this);
-        corner->setFixedSize(headerWidth + focusInnerHeaderWidth, headerHeight * 2);
-        layout->addWidget(corner, 0, 0, 2, 2);
-        m_headerWidgets.append(corner);
-    } else {
-        QLabel* corner = new QLabel(this);
-        corner->setText(" ");
-        corner->setAlignment(Qt::AlignCenter);
-        corner->setFixedSize(headerWidth, headerHeight);
-        layout->addWidget(corner, 0, 0);
-        m_headerWidgets.append(corner);
-    }
-
-    QVector<QString> colHeaders;
-    colHeaders.reserve(displayCols.size());
-
-    for (int i = 0; i < displayCols.size(); ++i) {
-        const int col = displayCols[i];
-        QString header = readCellText(2, col);
+    // 表头文本一次性生成；网格只绘制可见部分，不再为每个表头与数据项创建组件。
+    QVector<DataGridWidget::Axis> colAxes;
+    colAxes.reserve(displayCols.size());
+    for (const int col : std::as_const(displayCols)) {
+        QString header = m_document->cellText(2, col);
         if (header.isEmpty()) {
-            header = numToCol(col);
+            header = XLSXDocument::columnName(col);
         }
-        colHeaders.append(header);
+        QString inner;
+        if (mapping.enabled) {
+            inner = buildAxisValueText(header, mapping.dose(header));
+        }
+        colAxes.append({col, header, inner});
     }
 
-    QVector<QString> rowHeaders;
-    rowHeaders.reserve(displayRows.size());
-    for (int i = 0; i < displayRows.size(); ++i) {
-        const int row = displayRows[i];
-        QString header = readCellText(row, 1);
+    QVector<DataGridWidget::Axis> rowAxes;
+    rowAxes.reserve(displayRows.size());
+    for (const int row : std::as_const(displayRows)) {
+        QString header = m_document->cellText(row, 1);
         if (header.isEmpty()) {
             header = QString::number(row);
         }
-        rowHeaders.append(header);
-    }
-
-    const int itemWidth = static_cast<int>(std::round(kBaseItemWidth * m_itemScale));
-    const int itemHeight = static_cast<int>(std::round(kBaseItemHeight * m_itemScale));
-
-    for (int i = 0; i < displayCols.size(); ++i) {
-        const int col = displayCols[i];
-        QLabel* outerHeader = new QLabel(this);
-        outerHeader->setText(colHeaders[i]);
-        outerHeader->setAlignment(Qt::AlignCenter);
-        outerHeader->setWordWrap(true);
-        outerHeader->setToolTip(
-            QCoreApplication::translate("XLSXEditor", "Double-click to toggle this column"));
-        outerHeader->setProperty("batchAxis", "col");
-        outerHeader->setProperty("batchIndex", col);
-        outerHeader->installEventFilter(this);
-        outerHeader->setFixedSize(itemWidth, headerHeight);
-        layout->addWidget(outerHeader, 0, i + headerLayers);
-        m_headerWidgets.append(outerHeader);
-
-        if (m_axisHeaderConfigEnabled) {
-            QLabel* innerHeader = new QLabel(this);
-            innerHeader->setText(buildAxisValueText(colHeaders[i], m_doseCenter, m_doseStep, true));
-            innerHeader->setAlignment(Qt::AlignCenter);
-            innerHeader->setWordWrap(true);
-            innerHeader->setToolTip(
-                QCoreApplication::translate("XLSXEditor", "Double-click to toggle this column"));
-            innerHeader->setProperty("batchAxis", "col");
-            innerHeader->setProperty("batchIndex", col);
-            innerHeader->installEventFilter(this);
-            innerHeader->setFixedSize(itemWidth, headerHeight);
-            layout->addWidget(innerHeader, 1, i + headerLayers);
-            m_headerWidgets.append(innerHeader);
-        }
-    }
-
-    for (int i = 0; i < displayRows.size(); ++i) {
-        const int row = displayRows[i];
-        QLabel* outerHeader = new QLabel(this);
-        outerHeader->setText(rowHeaders[i]);
-        outerHeader->setAlignment(Qt::AlignCenter);
-        outerHeader->setWordWrap(true);
-        outerHeader->setToolTip(
-            QCoreApplication::translate("XLSXEditor", "Double-click to toggle this row"));
-        outerHeader->setProperty("batchAxis", "row");
-        outerHeader->setProperty("batchIndex", row);
-        outerHeader->installEventFilter(this);
-        outerHeader->setFixedSize(headerWidth, itemHeight);
-        layout->addWidget(outerHeader, i + headerLayers, 0);
-        m_headerWidgets.append(outerHeader);
-
-        if (m_axisHeaderConfigEnabled) {
-            QLabel* innerHeader = new QLabel(this);
-            innerHeader->setText(
-                buildAxisValueText(rowHeaders[i], m_focusCenter, m_focusStep, false));
-            innerHeader->setAlignment(Qt::AlignCenter);
-            innerHeader->setWordWrap(true);
-            innerHeader->setToolTip(
-                QCoreApplication::translate("XLSXEditor", "Double-click to toggle this row"));
-            innerHeader->setProperty("batchAxis", "row");
-            innerHeader->setProperty("batchIndex", row);
-            innerHeader->installEventFilter(this);
-            innerHeader->setFixedSize(focusInnerHeaderWidth, itemHeight);
-            layout->addWidget(innerHeader, i + headerLayers, 1);
-            m_headerWidgets.append(innerHeader);
+        QString inner;
+        if (mapping.enabled) {
+            inner = buildAxisValueText(header, mapping.focus(header));
         }
+        rowAxes.append({row, header, inner});
     }
+    axesTimer.addItems(rowAxes.size() + colAxes.size());
+    axesTimer.stop();
 
-    for (int i = 0; i < m_data.size(); ++i) {
-        const auto& entry = m_data[i];
-        if (entry.image.isNull()) {
-            continue;
-        }
-
-        DataItem* item = new DataItem(this);
-        item->applyScale(m_itemScale);
-        item->setImage(entry.image);
-        item->setDescription(entry.desc);
-        item->setDeleted(entry.deleted);
-        item->setRowCol(entry.row, entry.col);
-        if (!rowToGridRow.contains(entry.row)) {
-            continue;
-        }
-        if (!colToGridCol.contains(entry.col)) {
-            continue;
-        }
-        int gridRow = rowToGridRow.value(entry.row);
-        int gridCol = colToGridCol.value(entry.col);
-        layout->addWidget(item, gridRow, gridCol);
-        connect(item, &DataItem::deleteToggled, [this, i](bool deleted) {
-            m_data[i].deleted = deleted;
-            m_dirtyCells.insert(cellKey(m_data[i].row, m_data[i].col));
-            syncPreviewVisibility();
-            syncSelectAllState();
-        });
-        connect(item, &DataItem::descriptionEdited, [this, i](const QString& text) {
-            m_data[i].desc = text;
-            m_dirtyCells.insert(cellKey(m_data[i].row, m_data[i].col));
-        });
-        connect(item, &DataItem::imageEntered, this, &XLSXEditor::showHoverPreview);
-        connect(item, &DataItem::imageLeft, this, &XLSXEditor::hideHoverPreview);
-        m_dataItems.append(item);
-        m_itemByCell.insert(cellKey(entry.row, entry.col), item);
-    }
+    StageTimer gridTimer(profile.get(), "display.grid");
+    ui->dataGrid->setItemScale(m_itemScale);
+    ui->dataGrid->setPreviewOnly(m_previewOnly);
+    ui->dataGrid->setGrid(&data, rowAxes, colAxes, mapping.enabled);
+    gridTimer.addItems(data.size());
+    gridTimer.stop();
 
-    syncPreviewVisibility();
+    StageTimer layoutTimer(profile.get(), "display.layout");
     syncSelectAllState();
     updateScrollWidgetSize();
+    reportViewMemory();
+    layoutTimer.stop();
+
+    if (profile) {
+        m_displayTimings = profile->timings();
+        emit stageTimingsReady(QStringLiteral("display"), m_displayTimings);
+    }
 }
 
 void XLSXEditor::on_btnSave_clicked() {
-    if (saveData()) {
-        QMessageBox::information(this, QCoreApplication::translate("XLSXEditor", "Save"),
-                                 QCoreApplication::translate("XLSXEditor", "Data saved to XLSX: %1")
-                                     .arg(m_saveFilePath));
-    } else {
+    // 结果在 handleSaveFinished 中提示，界面在保存期间保持可编辑。
+    m_notifySaveResult = true;
+    if (!saveXLSX()) {
+        m_notifySaveResult = false;
         QMessageBox::critical(
             this, QCoreApplication::translate("XLSXEditor", "Save Error"),
             QCoreApplication::translate("XLSXEditor", "Failed to save data to XLSX."));
@@ -662,26 +447,11 @@ void XLSXEditor::on_btnPreview_clicked() {
 }
 
 void XLSXEditor::on_chkSelectAll_stateChanged(int state) {
-    if (m_syncingSelectAll || m_data.isEmpty()) {
+    if (m_syncingSelectAll || m_document->entries().isEmpty()) {
         return;
     }
 
-    const bool deleted = (state != Qt::Checked);
-    for (int i = 0; i < m_data.size(); ++i) {
-        if (m_data[i].deleted == deleted) {
-            continue;
-        }
-
-        m_data[i].deleted = deleted;
-        m_dirtyCells.insert(cellKey(m_data[i].row, m_data[i].col));
-
-        auto itemIt = m_itemByCell.find(cellKey(m_data[i].row, m_data[i].col));
-        if (itemIt != m_itemByCell.end() && itemIt.value() != nullptr) {
-            itemIt.value()->setDeleted(deleted);
-        }
-    }
-
-    syncPreviewVisibility();
+    m_document->setAllDeleted(state != Qt::Checked);
     syncSelectAllState();
 }
 
@@ -695,8 +465,10 @@ bool XLSXEditor::eventFilter(QObject* watched, QEvent* event) {
             if (m_hoverPreview) {
                 m_hoverPreview->hide();
             }
+            m_hoverOrigImage = QImage();
             m_hoverRow = -1;
             m_hoverCol = -1;
+            reportViewMemory();
             return true;
         } else if (event->type() == QEvent::MouseButtonPress) {
             auto* me = static_cast<QMouseEvent*>(event);
@@ -716,17 +488,16 @@ bool XLSXEditor::eventFilter(QObject* watched, QEvent* event) {
                 const int minSide = 50;
                 newSize.setWidth(std::max(minSide, newSize.width()));
                 newSize.setHeight(std::max(minSide, newSize.height()));
-                if (!m_hoverOrigPixmap.isNull()) {
-                    QPixmap scaled = m_hoverOrigPixmap.scaled(newSize, Qt::KeepAspectRatio,
-                                                              Qt::SmoothTransformation);
+                if (!m_hoverOrigImage.isNull()) {
+                    QPixmap scaled = QPixmap::fromImage(m_hoverOrigImage.scaled(
+                        newSize, Qt::KeepAspectRatio, Qt::SmoothTransformation));
                     m_hoverPreview->setPixmap(scaled);
                     m_hoverPreview->setFixedSize(scaled.size());
                     // 重新定位预览，使其仍然贴近触发图片位置
                     if (m_hoverRow >= 0 && m_hoverCol >= 0) {
-                        auto it = m_itemByCell.find(cellKey(m_hoverRow, m_hoverCol));
-                        if (it != m_itemByCell.end() && it.value() != nullptr) {
-                            DataItem* anchor = it.value();
-                            const QPoint g = anchor->imageWidgetGlobalPos();
+                        const int index = m_document->indexOf(m_hoverRow, m_hoverCol);
+                        if (index >= 0) {
+                            const QPoint g = ui->dataGrid->imageGlobalRect(index).topLeft();
                             const QPoint lp = this->mapFromGlobal(g);
                             const QSize s = scaled.size();
                             int nx = lp.x() + 20;
@@ -742,10 +513,9 @@ bool XLSXEditor::eventFilter(QObject* watched, QEvent* event) {
                 } else {
                     m_hoverPreview->setFixedSize(newSize);
                     if (m_hoverRow >= 0 && m_hoverCol >= 0) {
-                        auto it = m_itemByCell.find(cellKey(m_hoverRow, m_hoverCol));
-                        if (it != m_itemByCell.end() && it.value() != nullptr) {
-                            DataItem* anchor = it.value();
-                            const QPoint g = anchor->imageWidgetGlobalPos();
+                        const int index = m_document->indexOf(m_hoverRow, m_hoverCol);
+                        if (index >= 0) {
+                            const QPoint g = ui->dataGrid->imageGlobalRect(index).topLeft();
                             const QPoint lp = this->mapFromGlobal(g);
                             int nx = lp.x() + 20;
                             int ny = lp.y() - newSize.height() - 10;
@@ -773,63 +543,9 @@ bool XLSXEditor::eventFilter(QObject* watched, QEvent* event) {
             }
         }
     }
-    if (event->type() == QEvent::MouseButtonDblClick) {
-        auto* header = qobject_cast<QLabel*>(watched);
-        if (header != nullptr && header->property("batchAxis").isValid() &&
-            header->property("batchIndex").isValid()) {
-            const QString axis = header->property("batchAxis").toString();
-            const int index = header->property("batchIndex").toInt();
-
-            bool hasTarget = false;
-            bool allKept = true;
-            for (const auto& entry : std::as_const(m_data)) {
-                if (entry.image.isNull()) {
-                    continue;
-                }
-                if ((axis == "row" && entry.row != index) ||
-                    (axis == "col" && entry.col != index)) {
-                    continue;
-                }
-                hasTarget = true;
-                if (entry.deleted) {
-                    allKept = false;
-                    break;
-                }
-            }
-
-            if (!hasTarget) {
-                return true;
-            }
-
-            const bool nextDeleted = allKept;
-            for (int i = 0; i < m_data.size(); ++i) {
-                const auto& entry = m_data[i];
-                if (entry.image.isNull()) {
-                    continue;
-                }
-                if ((axis == "row" && entry.row != index) ||
-                    (axis == "col" && entry.col != index)) {
-                    continue;
-                }
-                if (m_data[i].deleted == nextDeleted) {
-                    continue;
-                }
-
-                m_data[i].deleted = nextDeleted;
-                m_dirtyCells.insert(cellKey(m_data[i].row, m_data[i].col));
-
-                auto itemIt = m_itemByCell.find(cellKey(m_data[i].row, m_data[i].col));
-                if (itemIt != m_itemByCell.end() && itemIt.value() != nullptr) {
-                    itemIt.value()->setDeleted(nextDeleted);
-                }
-            }
-
-            syncPreviewVisibility();
-            syncSelectAllState();
-            return true;
-        }
+    if (watched == ui->scrollArea->viewport() && event->type() == QEvent::Resize) {
+        prioritizeVisibleDecode();
     }
-
     if (watched == ui->scrollArea->viewport() && event->type() == QEvent::Wheel) {
         auto* wheelEvent = static_cast<QWheelEvent*>(event);
         if (wheelEvent->modifiers().testFlag(Qt::ControlModifier)) {
@@ -844,13 +560,12 @@ bool XLSXEditor::eventFilter(QObject* watched, QEvent* event) {
                 return true;
             }
 
+            const TraceSpan span("scale");
             m_itemScale = nextScale;
-            for (auto* item : m_dataItems) {
-                if (item) {
-                    item->applyScale(m_itemScale);
-                }
-            }
+            ui->dataGrid->setItemScale(m_itemScale);
             updateScrollWidgetSize();
+            reportViewMemory();
+            prioritizeVisibleDecode();
             wheelEvent->accept();
             return true;
         }
@@ -859,359 +574,57 @@ bool XLSXEditor::eventFilter(QObject* watched, QEvent* event) {
     return QWidget::eventFilter(watched, event);
 }
 
-bool XLSXEditor::saveData() {
-    if (!prepareSaveTargetFile()) {
-        return false;
-    }
-
-    const bool saved = m_dryRun ? saveFakeDelete() : saveRealDelete();
-    if (saved) {
-        m_dirtyCells.clear();
-    }
-    return saved;
+bool XLSXEditor::saveXLSX() {
+    return m_document->saveAsync();
 }
 
-bool XLSXEditor::prepareSaveTargetFile() {
-    if (m_filePath.isEmpty()) {
-        return false;
-    }
-
-    QFileInfo sourceInfo(m_filePath);
-    const QDir sourceDir = sourceInfo.absoluteDir();
-    const QString filteredDirPath = sourceDir.filePath("filtered");
-
-    QDir dir;
-    if (!dir.mkpath(filteredDirPath)) {
-        qWarning() << "Failed to create filtered folder:" << filteredDirPath;
-        return false;
-    }
-
-    const QString targetPath = QDir(filteredDirPath).filePath(sourceInfo.fileName());
-    QFile::remove(targetPath);
-    if (!QFile::copy(sourceInfo.absoluteFilePath(), targetPath)) {
-        qWarning() << "Failed to copy source xlsx to filtered target:" << targetPath;
-        return false;
-    }
-
-    if (m_wrapper) {
-        m_wrapper->close();
-        delete m_wrapper;
-        m_wrapper = nullptr;
-    }
-    if (m_pictureReader.isOpen()) {
-        m_pictureReader.close();
-    }
+bool XLSXEditor::isSaving() const {
+    return m_document->isSaving();
+}
 
-    m_saveFilePath = targetPath;
-    m_wrapper = new cc::neolux::utils::MiniXLSX::OpenXLSXWrapper();
-    if (!m_wrapper->open(m_saveFilePath.toStdString())) {
-        delete m_wrapper;
-        m_wrapper = nullptr;
-        qWarning() << "Failed to open filtered xlsx target:" << m_saveFilePath;
-        return false;
+void XLSXEditor::handleSaveFinished(const QString& targetPath, bool ok) {
+    endSaveProgress();
+    // 被合并的保存随后会以最新状态重新发起，结果提示留到最后一次。
+    if (m_document->isSavePending() || !std::exchange(m_notifySaveResult, false)) {
+        return;
     }
-
-    if (!m_pictureReader.open(m_saveFilePath.toStdString())) {
-        m_wrapper->close();
-        delete m_wrapper;
-        m_wrapper = nullptr;
-        qWarning() << "Failed to open picture reader on filtered xlsx target:" << m_saveFilePath;
-        return false;
+    if (ok) {
+        QMessageBox::information(
+            this, QCoreApplication::translate("XLSXEditor", "Save"),
+            QCoreApplication::translate("XLSXEditor", "Data saved to XLSX: %1").arg(targetPath));
+    } else {
+        QMessageBox::critical(
+            this, QCoreApplication::translate("XLSXEditor", "Save Error"),
+            QCoreApplication::translate("XLSXEditor", "Failed to save data to XLSX."));
     }
-
-    return true;
 }
 
-void XLSXEditor::beginSaveProgress(int maximum) {
-    if (!m_enableSaveProgress || !ui || !ui->progressBar) {
+void XLSXEditor::beginSaveProgress() {
+    if (!m_enableSaveProgress || !ui || !ui->progressBar || isLoading()) {
         return;
     }
-    ui->progressBar->setMinimum(0);
-    ui->progressBar->setMaximum(std::max(1, maximum));
+    ui->progressBar->setRange(0, 0);
     ui->progressBar->setValue(0);
     ui->progressBar->setFormat(QCoreApplication::translate("XLSXEditor", "Saving... %p%"));
     ui->progressBar->setVisible(true);
-    QCoreApplication::processEvents();
-}
-
-void XLSXEditor::updateSaveProgress(int value) {
-    if (!m_enableSaveProgress || !ui || !ui->progressBar || !ui->progressBar->isVisible()) {
-        return;
-    }
-    ui->progressBar->setValue(value);
-    QCoreApplication::processEvents();
 }
 
 void XLSXEditor::endSaveProgress() {
-    if (!m_enableSaveProgress || !ui || !ui->progressBar) {
+    if (!m_enableSaveProgress || !ui || !ui->progressBar || isLoading()) {
         return;
     }
     ui->progressBar->setFormat(QStringLiteral("%p%"));
     ui->progressBar->setVisible(false);
-    QCoreApplication::processEvents();
-}
-
-bool XLSXEditor::saveFakeDelete() {
-    const int total = std::max(1, static_cast<int>(m_data.size()) + 1);
-    beginSaveProgress(total);
-
-    int progress = 0;
-    for (const auto& entry : m_data) {
-        QString descCell = numToCol(entry.col) + QString::number(entry.row + 1);
-        cc::neolux::utils::MiniXLSX::CellStyle cs;
-        cs.backgroundColor = entry.deleted ? "#FF0000" : "";
-        m_wrapper->setCellValue(static_cast<unsigned int>(m_sheetIndex), descCell.toStdString(),
-                                entry.desc.toStdString());
-        m_wrapper->setCellStyle(static_cast<unsigned int>(m_sheetIndex), descCell.toStdString(),
-                                cs);
-        updateSaveProgress(++progress);
-    }
-
-    const bool ok = m_wrapper->save();
-    updateSaveProgress(total);
-    endSaveProgress();
-    return ok;
-}
-
-bool XLSXEditor::saveRealDelete() {
-    const int total = std::max(1, static_cast<int>(m_data.size()) + 8);
-    beginSaveProgress(total);
-    int progress = 0;
-
-    // 第 1 阶段：先通过 OpenXLSX 写回描述单元格（清空标记删除项）
-    // 这样可以确保文本与样式修改由上层接口稳定落盘。
-    for (const auto& entry : m_data) {
-        QString descCell = numToCol(entry.col) + QString::number(entry.row + 1);
-        cc::neolux::utils::MiniXLSX::CellStyle cs;
-        cs.backgroundColor = "";
-        m_wrapper->setCellStyle(static_cast<unsigned int>(m_sheetIndex), descCell.toStdString(),
-                                cs);
-        if (entry.deleted) {
-            m_wrapper->setCellValue(static_cast<unsigned int>(m_sheetIndex), descCell.toStdString(),
-                                    "");
-        } else {
-            m_wrapper->setCellValue(static_cast<unsigned int>(m_sheetIndex), descCell.toStdString(),
-                                    entry.desc.toStdString());
-        }
-        updateSaveProgress(++progress);
-    }
-
-    if (!m_wrapper->save()) {
-        qWarning() << "fail to save cell modifications";
-        endSaveProgress();
-        return false;
-    }
-    updateSaveProgress(++progress);
-
-    // 第 2 阶段：关闭 OpenXLSX 句柄，避免后续 XML 文件改写时的占用冲突。
-    m_wrapper->close();
-    delete m_wrapper;
-    m_wrapper = nullptr;
-
-    m_pictureReader.close();
-
-    // 第 3 阶段：重新解压文件，准备直接修改 drawing 与关系 XML。
-    if (!m_pictureReader.open(m_saveFilePath.toStdString())) {
-        endSaveProgress();
-        return false;
-    }
-    updateSaveProgress(++progress);
-
-    const std::string tempDir = m_pictureReader.getTempDir();
-    if (tempDir.empty()) {
-        endSaveProgress();
-        return false;
-    }
-
-    namespace fs = std::filesystem;
-    const fs::path unpackRoot(tempDir);
-    const fs::path drawingPath =
-        unpackRoot / "xl" / "drawings" / ("drawing" + std::to_string(m_sheetIndex + 1) + ".xml");
-    const fs::path drawingRelsPath =
-        drawingPath.parent_path() / "_rels" / (drawingPath.filename().string() + ".rels");
-
-    // 没有 drawing 文件说明当前表没有图片对象，直接恢复打开状态即可。
-    if (!fs::exists(drawingPath) || !fs::exists(drawingRelsPath)) {
-        m_wrapper = new cc::neolux::utils::MiniXLSX::OpenXLSXWrapper();
-        if (!m_wrapper->open(m_saveFilePath.toStdString())) {
-            endSaveProgress();
-            return false;
-        }
-        updateSaveProgress(total);
-        endSaveProgress();
-        return true;
-    }
-
-    // 收集需要删除的图片坐标（与 drawing 锚点坐标对齐）。
-    std::set<std::pair<int, int>> deletedCoords;
-    for (const auto& entry : m_data) {
-        if (entry.deleted) {
-            deletedCoords.insert({entry.row, entry.col});
-        }
-    }
-
-    pugi::xml_document drawingDoc;
-    if (!drawingDoc.load_file(drawingPath.c_str())) {
-        endSaveProgress();
-        return false;
-    }
-
-    pugi::xml_document relsDoc;
-    if (!relsDoc.load_file(drawingRelsPath.c_str())) {
-        endSaveProgress();
-        return false;
-    }
-    updateSaveProgress(++progress);
-
-    pugi::xml_node wsDr = drawingDoc.child("xdr:wsDr");
-    if (!wsDr) {
-        wsDr = drawingDoc.first_child();
-    }
-    if (!wsDr) {
-        endSaveProgress();
-        return false;
-    }
-
-    // 第 4 阶段：删除 drawing.xml 中对应图片锚点，记录 embedId。
-    std::unordered_set<std::string> removedEmbedIds;
-    for (pugi::xml_node anchor = wsDr.first_child(); anchor;) {
-        pugi::xml_node nextAnchor = anchor.next_sibling();
-        if (std::string(anchor.name()) != "xdr:twoCellAnchor") {
-            anchor = nextAnchor;
-            continue;
-        }
-
-        pugi::xml_node from = anchor.child("xdr:from");
-        const int colNum = from.child("xdr:col").text().as_int(-1) + 1;
-        const int rowNum = from.child("xdr:row").text().as_int(-1) + 1;
-        if (deletedCoords.find({rowNum, colNum}) == deletedCoords.end()) {
-            anchor = nextAnchor;
-            continue;
-        }
-
-        const std::string embedId = anchor.child("xdr:pic")
-                                        .child("xdr:blipFill")
-                                        .child("a:blip")
-                                        .attribute("r:embed")
-                                        .as_string();
-        if (!embedId.empty()) {
-            removedEmbedIds.insert(embedId);
-        }
-        wsDr.remove_child(anchor);
-        anchor = nextAnchor;
-    }
-
-    if (!drawingDoc.save_file(drawingPath.c_str(), PUGIXML_TEXT("  "))) {
-        endSaveProgress();
-        return false;
-    }
-    updateSaveProgress(++progress);
-
-    pugi::xml_node relRoot = relsDoc.child("Relationships");
-    if (!relRoot) {
-        relRoot = relsDoc.first_child();
-    }
-    if (!relRoot) {
-        endSaveProgress();
-        return false;
-    }
-
-    // 第 5 阶段：在 drawing rels 中删除 embedId 对应关系并记录图片目标路径。
-    std::unordered_set<std::string> removedTargets;
-    for (pugi::xml_node rel = relRoot.child("Relationship"); rel;) {
-        pugi::xml_node nextRel = rel.next_sibling("Relationship");
-        const std::string id = rel.attribute("Id").as_string();
-        if (removedEmbedIds.find(id) != removedEmbedIds.end()) {
-            const std::string target = rel.attribute("Target").as_string();
-            if (!target.empty()) {
-                removedTargets.insert(target);
-            }
-            relRoot.remove_child(rel);
-        }
-        rel = nextRel;
-    }
-
-    if (!relsDoc.save_file(drawingRelsPath.c_str(), PUGIXML_TEXT("  "))) {
-        endSaveProgress();
-        return false;
-    }
-    updateSaveProgress(++progress);
-
-    // 第 6 阶段：删除已不再被任何关系引用的 media 图片文件。
-    std::unordered_set<std::string> activeImageTargets;
-    for (pugi::xml_node rel = relRoot.child("Relationship"); rel;
-         rel = rel.next_sibling("Relationship")) {
-        const std::string type = rel.attribute("Type").as_string();
-        if (type.find("/image") != std::string::npos) {
-            activeImageTargets.insert(rel.attribute("Target").as_string());
-        }
-    }
-
-    for (const auto& target : removedTargets) {
-        if (activeImageTargets.find(target) != activeImageTargets.end()) {
-            continue;
-        }
-        const fs::path imagePath =
-            (drawingPath.parent_path() / fs::path(target)).lexically_normal();
-        if (fs::exists(imagePath)) {
-            std::error_code ec;
-            fs::remove(imagePath, ec);
-        }
-    }
-
-    // 第 7 阶段：将修改后的临时目录重新打包为 xlsx。
-    // 注意：打包前不能 close pictureReader，否则临时目录会被清理。
-    if (!cc::neolux::utils::KFZippa::zip(unpackRoot.string(), m_saveFilePath.toStdString())) {
-        qWarning() << "Failed to repack XLSX file";
-        m_pictureReader.close();
-        // Try to reopen anyway
-        m_wrapper = new cc::neolux::utils::MiniXLSX::OpenXLSXWrapper();
-        if (!m_wrapper->open(m_saveFilePath.toStdString())) {
-            endSaveProgress();
-            return false;
-        }
-        if (!m_pictureReader.open(m_saveFilePath.toStdString())) {
-            endSaveProgress();
-            return false;
-        }
-        endSaveProgress();
-        return false;
-    }
-    updateSaveProgress(++progress);
-
-    // 打包完成后再清理临时目录。
-    m_pictureReader.close();
-
-    // 第 8 阶段：重新打开读取器，保持编辑器处于可继续操作状态。
-    m_wrapper = new cc::neolux::utils::MiniXLSX::OpenXLSXWrapper();
-    if (!m_wrapper->open(m_saveFilePath.toStdString())) {
-        qWarning() << "Failed to reopen OpenXLSX after repacking";
-        endSaveProgress();
-        return false;
-    }
-
-    if (!m_pictureReader.open(m_saveFilePath.toStdString())) {
-        qWarning() << "Failed to reopen XLPictureReader after repacking";
-        endSaveProgress();
-        return false;
-    }
-
-    updateSaveProgress(total);
-    endSaveProgress();
-
-    return true;
 }
 
 // 已移除：旧的点击弹窗预览函数，改为悬停预览实现。
 
 void XLSXEditor::showHoverPreview(int row, int col) {
-    const QString key = cellKey(row, col);
-    auto it = m_itemByCell.find(key);
-    if (it == m_itemByCell.end() || it.value() == nullptr) {
-        return;
-    }
-    DataItem* item = it.value();
-    QImage img = item->getImage();
+    const TraceSpan span("hoverPreview", Tracer::isEnabled()
+                                             ? XLSXDocument::columnName(col) + QString::number(row)
+                                             : QString());
+    // 全分辨率图片经 LRU 缓存按需解码，与缓存共享像素数据。
+    const QImage img = m_document->pictureAt(row, col);
     if (img.isNull()) {
         return;
     }
@@ -1226,12 +639,11 @@ void XLSXEditor::showHoverPreview(int row, int col) {
     }
 
     const int maxSide = 1000;
-    // 保留原始像素图用于质量缩放
-    QPixmap orig = QPixmap::fromImage(img);
-    m_hoverOrigPixmap = orig;
+    // 保留原始图片用于质量缩放
+    m_hoverOrigImage = img;
 
     // 默认尺寸为原始尺寸的 2 倍（受上限限制），如果存在持久化尺寸则使用持久化尺寸
-    QSize defaultSize = orig.size() * 2;
+    QSize defaultSize = img.size() * 2;
     defaultSize.setWidth(std::min(defaultSize.width(), maxSide));
     defaultSize.setHeight(std::min(defaultSize.height(), maxSide));
 
@@ -1241,8 +653,8 @@ void XLSXEditor::showHoverPreview(int row, int col) {
         targetSize = m_savedHoverPreviewSize;
     }
 
-    QPixmap scaled =
-        m_hoverOrigPixmap.scaled(targetSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    QPixmap scaled = QPixmap::fromImage(
+        m_hoverOrigImage.scaled(targetSize, Qt::KeepAspectRatio, Qt::SmoothTransformation));
     m_hoverPreview->setPixmap(scaled);
     QSize finalSize = scaled.size();
     m_hoverPreview->setFixedSize(finalSize);
@@ -1268,49 +680,45 @@ void XLSXEditor::showHoverPreview(int row, int col) {
 
     m_hoverRow = row;
     m_hoverCol = col;
+    reportViewMemory();
 }
 
-void XLSXEditor::hideHoverPreview(int row, int col) {
-    Q_UNUSED(row);
-    Q_UNUSED(col);
-    // 关闭逻辑只由预览窗自身 Leave 事件驱动，避免从图片区域移出导致误关闭。
+void XLSXEditor::reportViewMemory() {
+    m_document->setViewMemory(ui ? ui->dataGrid->iconCacheBytes() : 0, previewMemory());
 }
 
-void XLSXEditor::updateScrollWidgetSize() {
-    int startRow, startCol, endRow, endCol;
-    parseRange(m_range, startRow, startCol, endRow, endCol);
+qint64 XLSXEditor::previewMemory() const {
+    qint64 previewBytes = m_hoverOrigImage.sizeInBytes();
+    if (m_hoverPreview) {
+        const QPixmap pixmap = m_hoverPreview->pixmap();
+        previewBytes += static_cast<qint64>(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+    }
+    return previewBytes;
+}
 
-    QSet<int> rowSet;
-    QSet<int> colSet;
-    for (const auto& entry : std::as_const(m_data)) {
-        if (!entry.image.isNull()) {
-            rowSet.insert(entry.row);
-            colSet.insert(entry.col);
+void XLSXEditor::prioritizeVisibleDecode() {
+    if (!m_document || !m_document->isLoading()) {
+        return;
+    }
+    // 视口内的单元格最先解码，其次是视口四周各一屏范围内的单元格，其余按锚点顺序。
+    const QWidget* viewport = ui->scrollArea->viewport();
+    const QRect visible(ui->dataGrid->mapFrom(viewport, QPoint(0, 0)), viewport->size());
+    QVector<int> order = ui->dataGrid->entriesIn(visible);
+    const QSet<int> inView(order.cbegin(), order.cend());
+    const QRect nearby = visible.adjusted(-visible.width(), -visible.height(), visible.width(),
+                                          visible.height());
+    for (const int index : ui->dataGrid->entriesIn(nearby)) {
+        if (!inView.contains(index)) {
+            order.append(index);
         }
     }
-    const int rowCount = rowSet.size();
-    const int colCount = colSet.size();
-    const int itemW = static_cast<int>(std::round(kBaseItemWidth * m_itemScale));
-    const int itemH = static_cast<int>(std::round(kBaseItemHeight * m_itemScale));
-    const int headerW = static_cast<int>(std::round(kBaseHeaderColWidth * m_itemScale));
-    const int headerH = static_cast<int>(std::round(kBaseHeaderRowHeight * m_itemScale));
-    const int headerLayers = m_axisHeaderConfigEnabled ? 2 : 1;
-    const int focusInnerHeaderW =
-        m_axisHeaderConfigEnabled
-            ? static_cast<int>(std::round(kBaseHeaderColWidth * 0.65 * m_itemScale))
-            : headerW;
-    const int totalHeaderBandW =
-        m_axisHeaderConfigEnabled ? (headerW + focusInnerHeaderW) : headerW;
-
-    const int contentW = colCount > 0
-                             ? totalHeaderBandW + colCount * itemW + colCount * kGridSpacing
-                             : totalHeaderBandW;
-    const int contentH = rowCount > 0
-                             ? headerLayers * headerH + rowCount * itemH + rowCount * kGridSpacing
-                             : headerLayers * headerH;
-
-    ui->scrollWidget->resize(contentW, contentH);
-    ui->scrollWidget->setMinimumSize(contentW, contentH);
+    m_document->prioritizeDecode(order);
+}
+
+void XLSXEditor::updateScrollWidgetSize() {
+    const QSize content = ui->dataGrid->contentSize();
+    ui->dataGrid->resize(content);
+    ui->dataGrid->setMinimumSize(content);
 }
 
 void XLSXEditor::syncPreviewButtonText() {
@@ -1322,15 +730,7 @@ void XLSXEditor::syncPreviewButtonText() {
 }
 
 void XLSXEditor::syncPreviewVisibility() {
-    for (int i = 0; i < m_data.size(); ++i) {
-        const auto& entry = m_data[i];
-        auto itemIt = m_itemByCell.find(cellKey(entry.row, entry.col));
-        if (itemIt == m_itemByCell.end() || itemIt.value() == nullptr) {
-            continue;
-        }
-        const bool visible = !m_previewOnly || !entry.deleted;
-        itemIt.value()->setVisible(visible);
-    }
+    ui->dataGrid->setPreviewOnly(m_previewOnly);
 }
 
 void XLSXEditor::syncSelectAllState() {
@@ -1339,20 +739,13 @@ void XLSXEditor::syncSelectAllState() {
     }
 
     m_syncingSelectAll = true;
-    if (m_data.isEmpty()) {
+    if (m_document->entries().isEmpty()) {
         ui->chkSelectAll->setCheckState(Qt::Unchecked);
         m_syncingSelectAll = false;
         return;
     }
 
-    int deletedCount = 0;
-    for (const auto& entry : std::as_const(m_data)) {
-        if (entry.deleted) {
-            ++deletedCount;
-        }
-    }
-
-    const bool allKept = (deletedCount == 0);
+    const bool allKept = (m_document->deletedCount() == 0);
     ui->chkSelectAll->setCheckState(allKept ? Qt::Checked : Qt::Unchecked);
     m_syncingSelectAll = false;
 }
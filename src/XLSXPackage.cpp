@@ -0,0 +1,988 @@
+#include "cc/neolux/fem/xlsxeditor/XLSXPackage.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <optional>
+#include <pugixml.hpp>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "cc/neolux/fem/xlsxeditor/ZipWriter.hpp"
+
+namespace {
+const char* localName(const char* name) {
+    const char* colon = std::strchr(name, ':');
+    return colon ? colon + 1 : name;
+}
+
+/** @brief 忽略命名空间前缀查找子节点（不同生成器使用的前缀不一致）。 */
+pugi::xml_node childByLocalName(const pugi::xml_node& node, const char* name) {
+    for (pugi::xml_node child = node.first_child(); child; child = child.next_sibling()) {
+        if (child.type() == pugi::node_element && std::strcmp(localName(child.name()), name) == 0) {
+            return child;
+        }
+    }
+    return pugi::xml_node();
+}
+
+pugi::xml_attribute attributeByLocalName(const pugi::xml_node& node, const char* name) {
+    for (pugi::xml_attribute attr = node.first_attribute(); attr; attr = attr.next_attribute()) {
+        if (std::strcmp(localName(attr.name()), name) == 0) {
+            return attr;
+        }
+    }
+    return pugi::xml_attribute();
+}
+
+bool endsWith(const std::string& text, const char* suffix) {
+    const size_t len = std::strlen(suffix);
+    return text.size() >= len && text.compare(text.size() - len, len, suffix) == 0;
+}
+
+/** @brief 拼接 <si>/<is> 下的全部文本段（含富文本 <r>，跳过注音 <rPh>）。 */
+std::string stringItemText(const pugi::xml_node& item) {
+    std::string text;
+    for (pugi::xml_node child = item.first_child(); child; child = child.next_sibling()) {
+        const char* name = localName(child.name());
+        if (std::strcmp(name, "t") == 0) {
+            text += child.text().get();
+        } else if (std::strcmp(name, "r") == 0) {
+            text += childByLocalName(child, "t").text().get();
+        }
+    }
+    return text;
+}
+
+/** @brief 解析 A1 形式的单元格引用，失败返回 false。 */
+bool parseCellRef(const char* ref, int& row, int& col) {
+    row = 0;
+    col = 0;
+    const char* p = ref;
+    for (; (*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z'); ++p) {
+        col = col * 26 + ((*p & ~0x20) - 'A' + 1);
+    }
+    for (; *p >= '0' && *p <= '9'; ++p) {
+        row = row * 10 + (*p - '0');
+    }
+    return *p == '\0' && row > 0 && col > 0;
+}
+
+bool loadXml(const cc::neolux::fem::xlsxeditor::XLSXPackage& package, const std::string& path,
+             pugi::xml_document& doc) {
+    std::string content;
+    if (!package.readPart(path, content)) {
+        return false;
+    }
+    return static_cast<bool>(doc.load_buffer(content.data(), content.size()));
+}
+
+struct StringWriter : pugi::xml_writer {
+    std::string out;
+
+    void write(const void* data, size_t size) override {
+        out.append(static_cast<const char*>(data), size);
+    }
+};
+
+/** @brief 按原样（不缩进）序列化 XML，保留声明。 */
+std::string saveXml(const pugi::xml_document& doc) {
+    StringWriter writer;
+    doc.save(writer, "", pugi::format_raw);
+    return writer.out;
+}
+
+/** @brief 生成 A1 形式的单元格引用。 */
+std::string cellRef(int row, int col) {
+    std::string letters;
+    for (; col > 0; col = (col - 1) / 26) {
+        letters.insert(letters.begin(), static_cast<char>('A' + (col - 1) % 26));
+    }
+    return letters + std::to_string(row);
+}
+
+/** @brief 节点名称的命名空间前缀（含冒号），新建的兄弟节点沿用同一前缀。 */
+std::string prefixOf(const pugi::xml_node& node) {
+    const char* name = node.name();
+    const char* colon = std::strchr(name, ':');
+    return colon ? std::string(name, colon + 1) : std::string();
+}
+
+/** @brief 更新集合节点的 count 属性（存在时）。 */
+void updateCount(pugi::xml_node node, size_t count) {
+    if (pugi::xml_attribute attr = node.attribute("count")) {
+        attr.set_value(static_cast<unsigned>(count));
+    }
+}
+
+/** @brief 按需克隆 cellXfs 样式并替换填充，同一 (样式, 填充) 组合只克隆一次。 */
+class FillStyler {
+public:
+    explicit FillStyler(pugi::xml_document& doc)
+        : m_fills(childByLocalName(doc.document_element(), "fills")),
+          m_cellXfs(childByLocalName(doc.document_element(), "cellXfs")) {
+        for (pugi::xml_node fill = m_fills.first_child(); fill; fill = fill.next_sibling()) {
+            if (std::strcmp(localName(fill.name()), "fill") != 0) {
+                continue;
+            }
+            const pugi::xml_node pattern = childByLocalName(fill, "patternFill");
+            const std::string rgb =
+                childByLocalName(pattern, "fgColor").attribute("rgb").as_string();
+            if (std::strcmp(pattern.attribute("patternType").as_string(), "solid") == 0 &&
+                !rgb.empty()) {
+                m_fillByColor.emplace(rgb, m_fillCount);
+            }
+            ++m_fillCount;
+        }
+        for (pugi::xml_node xf = m_cellXfs.first_child(); xf; xf = xf.next_sibling()) {
+            if (std::strcmp(localName(xf.name()), "xf") == 0) {
+                m_xfs.push_back(xf);
+            }
+        }
+    }
+
+    bool isValid() const { return m_fills && m_cellXfs && !m_xfs.empty(); }
+    bool isModified() const { return m_modified; }
+
+    /**
+     * @brief 返回与 styleIndex 相同、仅填充换成 color 的样式索引。
+     * @param color ARGB 颜色，空串表示无填充（fillId 0）。
+     */
+    int apply(int styleIndex, const std::string& color) {
+        if (styleIndex < 0 || styleIndex >= static_cast<int>(m_xfs.size())) {
+            styleIndex = 0;
+        }
+        const int fill = fillId(color);
+        if (m_xfs[styleIndex].attribute("fillId").as_int(0) == fill) {
+            return styleIndex;
+        }
+        const auto key = std::make_pair(styleIndex, fill);
+        auto it = m_cloned.find(key);
+        if (it != m_cloned.end()) {
+            return it->second;
+        }
+
+        pugi::xml_node xf = m_cellXfs.insert_copy_after(m_xfs[styleIndex], m_xfs.back());
+        setAttribute(xf, "fillId", std::to_string(fill));
+        setAttribute(xf, "applyFill", "1");
+        m_xfs.push_back(xf);
+        updateCount(m_cellXfs, m_xfs.size());
+        m_modified = true;
+        const int index = static_cast<int>(m_xfs.size()) - 1;
+        m_cloned.emplace(key, index);
+        return index;
+    }
+
+private:
+    pugi::xml_node m_fills;
+    pugi::xml_node m_cellXfs;
+    std::vector<pugi::xml_node> m_xfs;
+    std::map<std::string, int> m_fillByColor;
+    std::map<std::pair<int, int>, int> m_cloned;
+    int m_fillCount = 0;
+    bool m_modified = false;
+
+    static void setAttribute(pugi::xml_node node, const char* name, const std::string& value) {
+        pugi::xml_attribute attr = node.attribute(name);
+        if (!attr) {
+            attr = node.append_attribute(name);
+        }
+        attr.set_value(value.c_str());
+    }
+
+    int fillId(const std::string& color) {
+        if (color.empty()) {
+            return 0;
+        }
+        auto it = m_fillByColor.find(color);
+        if (it != m_fillByColor.end()) {
+            return it->second;
+        }
+        const std::string prefix = prefixOf(m_fills);
+        pugi::xml_node pattern = m_fills.append_child((prefix + "fill").c_str())
+                                     .append_child((prefix + "patternFill").c_str());
+        pattern.append_attribute("patternType").set_value("solid");
+        pattern.append_child((prefix + "fgColor").c_str())
+            .append_attribute("rgb")
+            .set_value(color.c_str());
+        pattern.append_child((prefix + "bgColor").c_str())
+            .append_attribute("indexed")
+            .set_value("64");
+        updateCount(m_fills, static_cast<size_t>(m_fillCount) + 1);
+        m_modified = true;
+        m_fillByColor.emplace(color, m_fillCount);
+        return m_fillCount++;
+    }
+};
+
+/** @brief 查找或按行号顺序插入 <row>。 */
+pugi::xml_node ensureRow(pugi::xml_node sheetData, std::map<int, pugi::xml_node>& rows, int row) {
+    auto it = rows.lower_bound(row);
+    if (it != rows.end() && it->first == row) {
+        return it->second;
+    }
+    const std::string name = prefixOf(sheetData) + "row";
+    pugi::xml_node node = it == rows.end()
+                              ? sheetData.append_child(name.c_str())
+                              : sheetData.insert_child_before(name.c_str(), it->second);
+    node.append_attribute("r").set_value(row);
+    rows.emplace(row, node);
+    return node;
+}
+
+/** @brief 在 <row> 中查找或按列顺序插入 <c>。 */
+pugi::xml_node ensureCell(pugi::xml_node rowNode, int row, int col) {
+    int nextCol = 1;
+    pugi::xml_node before;
+    for (pugi::xml_node cell = rowNode.first_child(); cell; cell = cell.next_sibling()) {
+        if (std::strcmp(localName(cell.name()), "c") != 0) {
+            continue;
+        }
+        int cellRow = 0;
+        int cellCol = nextCol;
+        if (!parseCellRef(cell.attribute("r").as_string(), cellRow, cellCol)) {
+            cellCol = nextCol;
+        }
+        nextCol = cellCol + 1;
+        if (cellCol == col) {
+            return cell;
+        }
+        if (cellCol > col) {
+            before = cell;
+            break;
+        }
+    }
+    const std::string name = prefixOf(rowNode) + "c";
+    pugi::xml_node cell = before ? rowNode.insert_child_before(name.c_str(), before)
+                                 : rowNode.append_child(name.c_str());
+    cell.append_attribute("r").set_value(cellRef(row, col).c_str());
+    return cell;
+}
+
+/** @brief 以内联字符串写入单元格文本；空文本只清空值。公式由调用方先行处理。 */
+void setCellText(pugi::xml_node cell, const std::string& text) {
+    for (pugi::xml_node child = cell.first_child(); child;) {
+        const pugi::xml_node next = child.next_sibling();
+        const char* name = localName(child.name());
+        if (std::strcmp(name, "f") == 0 || std::strcmp(name, "v") == 0 ||
+            std::strcmp(name, "is") == 0) {
+            cell.remove_child(child);
+        }
+        child = next;
+    }
+    cell.remove_attribute("t");
+    if (text.empty()) {
+        return;
+    }
+
+    cell.append_attribute("t").set_value("inlineStr");
+    const std::string prefix = prefixOf(cell);
+    // 值元素必须位于 extLst 之前，前插即可保证顺序。
+    pugi::xml_node t =
+        cell.prepend_child((prefix + "is").c_str()).append_child((prefix + "t").c_str());
+    if (std::isspace(static_cast<unsigned char>(text.front())) ||
+        std::isspace(static_cast<unsigned char>(text.back()))) {
+        t.append_attribute("xml:space").set_value("preserve");
+    }
+    t.text().set(text.c_str());
+}
+
+/**
+ * @brief 收集子树中引用关系的 Id：r:embed、r:link 与带前缀的 r:id（如超链接），
+ *        组合形状（grpSp）内部的图片同样计入。
+ */
+void collectRelationshipIds(const pugi::xml_node& root, std::unordered_set<std::string>& ids) {
+    std::vector<pugi::xml_node> pending{root};
+    while (!pending.empty()) {
+        const pugi::xml_node node = pending.back();
+        pending.pop_back();
+        for (pugi::xml_attribute attr = node.first_attribute(); attr;
+             attr = attr.next_attribute()) {
+            const char* name = attr.name();
+            const char* local = localName(name);
+            if (std::strcmp(local, "embed") == 0 || std::strcmp(local, "link") == 0 ||
+                (local != name && std::strcmp(local, "id") == 0)) {
+                if (*attr.value() != '\0') {
+                    ids.insert(attr.value());
+                }
+            }
+        }
+        for (pugi::xml_node child = node.first_child(); child; child = child.next_sibling()) {
+            if (child.type() == pugi::node_element) {
+                pending.push_back(child);
+            }
+        }
+    }
+}
+
+constexpr const char* kContentTypesPath = "[Content_Types].xml";
+}  // namespace
+
+namespace cc::neolux::fem::xlsxeditor {
+
+bool XLSXPackage::open(const std::string& path) {
+    close();
+    if (!m_archive.open(path)) {
+        return false;
+    }
+
+    m_workbookPath = "xl/workbook.xml";
+    for (const auto& rel : relationships("")) {
+        if (!rel.external && endsWith(rel.type, "/officeDocument")) {
+            m_workbookPath = rel.target;
+            break;
+        }
+    }
+
+    pugi::xml_document workbook;
+    if (!loadXml(*this, m_workbookPath, workbook)) {
+        close();
+        return false;
+    }
+
+    std::unordered_map<std::string, std::string> targetById;
+    for (const auto& rel : relationships(m_workbookPath)) {
+        targetById.emplace(rel.id, rel.target);
+    }
+
+    const pugi::xml_node sheets = childByLocalName(workbook.document_element(), "sheets");
+    for (pugi::xml_node sheet = sheets.first_child(); sheet; sheet = sheet.next_sibling()) {
+        if (std::strcmp(localName(sheet.name()), "sheet") != 0) {
+            continue;
+        }
+        auto it = targetById.find(attributeByLocalName(sheet, "id").as_string());
+        m_sheets.push_back({sheet.attribute("name").as_string(),
+                            it != targetById.end() ? it->second : "",
+                            sheet.attribute("sheetId").as_int(0)});
+    }
+    return true;
+}
+
+void XLSXPackage::close() {
+    m_archive.close();
+    m_workbookPath.clear();
+    m_sheets.clear();
+    m_sharedStrings.clear();
+    m_sharedStringsLoaded = false;
+}
+
+std::string XLSXPackage::sheetName(int index) const {
+    return index >= 0 && index < sheetCount() ? m_sheets[index].name : std::string();
+}
+
+int XLSXPackage::sheetIndex(const std::string& name) const {
+    for (int i = 0; i < sheetCount(); ++i) {
+        if (m_sheets[i].name == name) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int XLSXPackage::sheetId(int sheetIndex) const {
+    return sheetIndex >= 0 && sheetIndex < sheetCount() ? m_sheets[sheetIndex].sheetId : 0;
+}
+
+std::string XLSXPackage::worksheetPath(int sheetIndex) const {
+    return sheetIndex >= 0 && sheetIndex < sheetCount() ? m_sheets[sheetIndex].path
+                                                        : std::string();
+}
+
+std::string XLSXPackage::drawingPath(int sheetIndex) const {
+    const std::string sheetPath = worksheetPath(sheetIndex);
+    if (sheetPath.empty()) {
+        return "";
+    }
+    for (const auto& rel : relationships(sheetPath)) {
+        if (!rel.external && endsWith(rel.type, "/drawing")) {
+            return rel.target;
+        }
+    }
+    return "";
+}
+
+std::vector<PictureAnchor> XLSXPackage::sheetPictures(int sheetIndex) const {
+    std::vector<PictureAnchor> pictures;
+    const std::string drawing = drawingPath(sheetIndex);
+    if (drawing.empty()) {
+        return pictures;
+    }
+
+    std::unordered_map<std::string, std::string> targetById;
+    for (const auto& rel : relationships(drawing)) {
+        if (!rel.external) {
+            targetById.emplace(rel.id, rel.target);
+        }
+    }
+
+    pugi::xml_document doc;
+    if (!loadXml(*this, drawing, doc)) {
+        return pictures;
+    }
+
+    for (pugi::xml_node anchor = doc.document_element().first_child(); anchor;
+         anchor = anchor.next_sibling()) {
+        const char* anchorName = localName(anchor.name());
+        if (std::strcmp(anchorName, "twoCellAnchor") != 0 &&
+            std::strcmp(anchorName, "oneCellAnchor") != 0) {
+            continue;
+        }
+        const pugi::xml_node from = childByLocalName(anchor, "from");
+        const pugi::xml_node blip =
+            childByLocalName(childByLocalName(childByLocalName(anchor, "pic"), "blipFill"), "blip");
+        auto it = targetById.find(attributeByLocalName(blip, "embed").as_string());
+        if (!from || it == targetById.end()) {
+            continue;
+        }
+        pictures.push_back({childByLocalName(from, "row").text().as_int(-1) + 1,
+                            childByLocalName(from, "col").text().as_int(-1) + 1, it->second});
+    }
+    return pictures;
+}
+
+bool XLSXPackage::readCells(int sheetIndex, const std::vector<CellRange>& ranges,
+                            CellTable& table) const {
+    pugi::xml_document doc;
+    if (!loadXml(*this, worksheetPath(sheetIndex), doc)) {
+        return false;
+    }
+    if (ranges.empty()) {
+        return true;
+    }
+
+    int minRow = ranges.front().firstRow;
+    int maxRow = ranges.front().lastRow;
+    for (const auto& range : ranges) {
+        minRow = std::min(minRow, range.firstRow);
+        maxRow = std::max(maxRow, range.lastRow);
+    }
+    auto inRanges = [&ranges](int row, int col) {
+        return std::any_of(ranges.begin(), ranges.end(),
+                           [row, col](const CellRange& range) { return range.contains(row, col); });
+    };
+
+    const pugi::xml_node sheetData = childByLocalName(doc.document_element(), "sheetData");
+    int rowNum = 0;
+    for (pugi::xml_node row = sheetData.first_child(); row; row = row.next_sibling()) {
+        if (std::strcmp(localName(row.name()), "row") != 0) {
+            continue;
+        }
+        // 省略 r 属性时按出现顺序递增
+        rowNum = row.attribute("r").as_int(rowNum + 1);
+        if (rowNum < minRow) {
+            continue;
+        }
+        if (rowNum > maxRow) {
+            break;
+        }
+
+        int colNum = 0;
+        for (pugi::xml_node cell = row.first_child(); cell; cell = cell.next_sibling()) {
+            if (std::strcmp(localName(cell.name()), "c") != 0) {
+                continue;
+            }
+            // 省略 r 属性时列号同样按出现顺序递增
+            int refRow = 0;
+            int refCol = 0;
+            if (!parseCellRef(cell.attribute("r").as_string(), refRow, refCol)) {
+                refCol = colNum + 1;
+            }
+            colNum = refCol;
+            if (!inRanges(rowNum, colNum)) {
+                continue;
+            }
+
+            const char* type = cell.attribute("t").as_string();
+            std::string text;
+            if (std::strcmp(type, "inlineStr") == 0) {
+                text = stringItemText(childByLocalName(cell, "is"));
+            } else if (std::strcmp(type, "s") == 0) {
+                const auto& strings = sharedStrings();
+                const int index = childByLocalName(cell, "v").text().as_int(-1);
+                if (index >= 0 && index < static_cast<int>(strings.size())) {
+                    text = strings[index];
+                }
+            } else {
+                text = childByLocalName(cell, "v").text().get();
+            }
+            const int styleIndex = cell.attribute("s").as_int(0);
+            if (!text.empty() || styleIndex != 0) {
+                table.insert(rowNum, colNum, std::move(text), styleIndex);
+            }
+        }
+    }
+    return true;
+}
+
+std::string XLSXPackage::stylesPath() const {
+    for (const auto& rel : relationships(m_workbookPath)) {
+        if (!rel.external && endsWith(rel.type, "/styles")) {
+            return rel.target;
+        }
+    }
+    return "";
+}
+
+std::string XLSXPackage::calcChainPath() const {
+    for (const auto& rel : relationships(m_workbookPath)) {
+        if (!rel.external && endsWith(rel.type, "/calcChain")) {
+            return rel.target;
+        }
+    }
+    return "";
+}
+
+std::vector<bool> XLSXPackage::filledStyles() const {
+    std::vector<bool> filled;
+    const std::string path = stylesPath();
+    pugi::xml_document doc;
+    if (path.empty() || !loadXml(*this, path, doc)) {
+        return filled;
+    }
+
+    std::vector<bool> fillHasPattern;
+    const pugi::xml_node fills = childByLocalName(doc.document_element(), "fills");
+    for (pugi::xml_node fill = fills.first_child(); fill; fill = fill.next_sibling()) {
+        if (std::strcmp(localName(fill.name()), "fill") != 0) {
+            continue;
+        }
+        // gradientFill 或非 none 的 patternFill 都视为有填充
+        const pugi::xml_node pattern = childByLocalName(fill, "patternFill");
+        const char* type = pattern.attribute("patternType").as_string();
+        fillHasPattern.push_back(static_cast<bool>(childByLocalName(fill, "gradientFill")) ||
+                                 (*type != '\0' && std::strcmp(type, "none") != 0));
+    }
+
+    const pugi::xml_node cellXfs = childByLocalName(doc.document_element(), "cellXfs");
+    for (pugi::xml_node xf = cellXfs.first_child(); xf; xf = xf.next_sibling()) {
+        if (std::strcmp(localName(xf.name()), "xf") != 0) {
+            continue;
+        }
+        const int fillId = xf.attribute("fillId").as_int(0);
+        filled.push_back(fillId >= 0 && fillId < static_cast<int>(fillHasPattern.size()) &&
+                         fillHasPattern[fillId]);
+    }
+    return filled;
+}
+
+const std::vector<std::string>& XLSXPackage::sharedStrings() const {
+    if (m_sharedStringsLoaded) {
+        return m_sharedStrings;
+    }
+    m_sharedStringsLoaded = true;
+
+    std::string path;
+    for (const auto& rel : relationships(m_workbookPath)) {
+        if (!rel.external && endsWith(rel.type, "/sharedStrings")) {
+            path = rel.target;
+            break;
+        }
+    }
+    pugi::xml_document doc;
+    if (path.empty() || !loadXml(*this, path, doc)) {
+        return m_sharedStrings;
+    }
+    for (pugi::xml_node item = doc.document_element().first_child(); item;
+         item = item.next_sibling()) {
+        if (std::strcmp(localName(item.name()), "si") == 0) {
+            m_sharedStrings.push_back(stringItemText(item));
+        }
+    }
+    return m_sharedStrings;
+}
+
+std::vector<PackageRelationship> XLSXPackage::relationships(const std::string& partPath) const {
+    std::vector<PackageRelationship> rels;
+    pugi::xml_document doc;
+    if (!loadXml(*this, relsPathFor(partPath), doc)) {
+        return rels;
+    }
+    for (pugi::xml_node rel = doc.document_element().first_child(); rel;
+         rel = rel.next_sibling()) {
+        if (std::strcmp(localName(rel.name()), "Relationship") != 0) {
+            continue;
+        }
+        const bool external = std::strcmp(rel.attribute("TargetMode").as_string(), "External") == 0;
+        const std::string target = rel.attribute("Target").as_string();
+        rels.push_back({rel.attribute("Id").as_string(), rel.attribute("Type").as_string(),
+                        external ? target : resolveTarget(partPath, target), external});
+    }
+    return rels;
+}
+
+bool XLSXPackage::readPart(const std::string& partPath, std::string& out) const {
+    return m_archive.read(partPath, out);
+}
+
+std::string XLSXPackage::relsPathFor(const std::string& partPath) {
+    const size_t slash = partPath.rfind('/');
+    if (slash == std::string::npos) {
+        return "_rels/" + partPath + ".rels";
+    }
+    return partPath.substr(0, slash + 1) + "_rels/" + partPath.substr(slash + 1) + ".rels";
+}
+
+std::string XLSXPackage::resolveTarget(const std::string& sourcePart, const std::string& target) {
+    if (!target.empty() && target.front() == '/') {
+        return target.substr(1);
+    }
+
+    const size_t slash = sourcePart.rfind('/');
+    const std::string joined =
+        (slash == std::string::npos ? std::string() : sourcePart.substr(0, slash + 1)) + target;
+
+    // 规整 "." 与 ".." 段
+    std::vector<std::string> segments;
+    size_t start = 0;
+    while (start <= joined.size()) {
+        size_t end = joined.find('/', start);
+        if (end == std::string::npos) {
+            end = joined.size();
+        }
+        const std::string segment = joined.substr(start, end - start);
+        if (segment == "..") {
+            if (!segments.empty()) {
+                segments.pop_back();
+            }
+        } else if (!segment.empty() && segment != ".") {
+            segments.push_back(segment);
+        }
+        start = end + 1;
+    }
+
+    std::string resolved;
+    for (const auto& segment : segments) {
+        if (!resolved.empty()) {
+            resolved += '/';
+        }
+        resolved += segment;
+    }
+    return resolved;
+}
+
+void PackageRewriter::replacePart(const std::string& partPath, std::string content) {
+    m_removed.erase(partPath);
+    m_replaced[partPath] = std::move(content);
+}
+
+void PackageRewriter::removePart(const std::string& partPath) {
+    m_replaced.erase(partPath);
+    m_removed.insert(partPath);
+}
+
+bool PackageRewriter::readPart(const std::string& partPath, std::string& out) const {
+    if (m_removed.count(partPath) > 0) {
+        return false;
+    }
+    auto it = m_replaced.find(partPath);
+    if (it != m_replaced.end()) {
+        out = it->second;
+        return true;
+    }
+    return m_package.readPart(partPath, out);
+}
+
+bool PackageRewriter::loadPart(const std::string& partPath, pugi::xml_document& doc) const {
+    std::string content;
+    if (!readPart(partPath, content)) {
+        return false;
+    }
+    // 改写后需原样写回：保留 XML 声明与仅含空白的文本节点（如 <t xml:space="preserve"> </t>）。
+    return static_cast<bool>(doc.load_buffer(
+        content.data(), content.size(),
+        pugi::parse_default | pugi::parse_declaration | pugi::parse_ws_pcdata_single));
+}
+
+bool PackageRewriter::writeCells(int sheetIndex, const std::vector<CellEdit>& edits) {
+    const std::string sheetPath = m_package.worksheetPath(sheetIndex);
+    if (sheetPath.empty()) {
+        return false;
+    }
+    if (edits.empty()) {
+        return true;
+    }
+
+    pugi::xml_document sheetDoc;
+    if (!loadPart(sheetPath, sheetDoc)) {
+        return false;
+    }
+    pugi::xml_node sheetData = childByLocalName(sheetDoc.document_element(), "sheetData");
+    if (!sheetData) {
+        return false;
+    }
+
+    // 样式表只在第一次真正改动填充时加载：纯文本改写不依赖 styles.xml 是否存在或可解析。
+    const std::string stylesPath = m_package.stylesPath();
+    pugi::xml_document stylesDoc;
+    std::optional<FillStyler> styler;
+
+    // 一次遍历建立行号索引，之后每个改写的定位与插入都不再扫描整张表。
+    std::map<int, pugi::xml_node> rows;
+    int lastRow = 0;
+    for (pugi::xml_node row = sheetData.first_child(); row; row = row.next_sibling()) {
+        if (std::strcmp(localName(row.name()), "row") == 0) {
+            lastRow = row.attribute("r").as_int(lastRow + 1);
+            rows.emplace(lastRow, row);
+        }
+    }
+
+    std::set<std::pair<int, int>> droppedFormulas;
+    for (const auto& edit : edits) {
+        pugi::xml_node cell = ensureCell(ensureRow(sheetData, rows, edit.row), edit.row, edit.col);
+        if (const pugi::xml_node formula = childByLocalName(cell, "f")) {
+            // 带 ref 的 <f> 是共享公式或数组公式的主单元格，其余单元格的公式依赖它。
+            if (formula.attribute("ref")) {
+                return false;
+            }
+            droppedFormulas.insert({edit.row, edit.col});
+        }
+        setCellText(cell, edit.text);
+
+        const int current = cell.attribute("s").as_int(0);
+        if (edit.fillColor.empty() && (current == 0 || stylesPath.empty())) {
+            continue;  // 没有可去掉的填充
+        }
+        if (!styler) {
+            if (stylesPath.empty() || !loadPart(stylesPath, stylesDoc)) {
+                return false;
+            }
+            styler.emplace(stylesDoc);
+            if (!styler->isValid()) {
+                return false;
+            }
+        }
+        const int style = styler->apply(current, edit.fillColor);
+        if (style == 0) {
+            cell.remove_attribute("s");
+        } else if (pugi::xml_attribute attr = cell.attribute("s")) {
+            attr.set_value(style);
+        } else {
+            cell.append_attribute("s").set_value(style);
+        }
+    }
+
+    if (!droppedFormulas.empty() && !removeCalcChainEntries(sheetIndex, droppedFormulas)) {
+        return false;
+    }
+    replacePart(sheetPath, saveXml(sheetDoc));
+    if (styler && styler->isModified()) {
+        replacePart(stylesPath, saveXml(stylesDoc));
+    }
+    return true;
+}
+
+bool PackageRewriter::removeCalcChainEntries(int sheetIndex,
+                                             const std::set<std::pair<int, int>>& cells) {
+    const std::string chainPath = m_package.calcChainPath();
+    pugi::xml_document chainDoc;
+    if (chainPath.empty() || !loadPart(chainPath, chainDoc)) {
+        return true;  // 没有计算链，Excel 打开时会自行重建
+    }
+    const int sheetId = m_package.sheetId(sheetIndex);
+
+    pugi::xml_node chain = chainDoc.document_element();
+    int currentSheet = 0;
+    bool removed = false;
+    bool empty = true;
+    for (pugi::xml_node c = chain.first_child(); c;) {
+        const pugi::xml_node next = c.next_sibling();
+        if (std::strcmp(localName(c.name()), "c") != 0) {
+            c = next;
+            continue;
+        }
+        // 省略 i 的条目沿用前一条的工作表。
+        const pugi::xml_attribute sheetAttr = c.attribute("i");
+        currentSheet = sheetAttr.as_int(currentSheet);
+        int row = 0;
+        int col = 0;
+        if (currentSheet != sheetId || !parseCellRef(c.attribute("r").as_string(), row, col) ||
+            cells.count({row, col}) == 0) {
+            empty = false;
+            c = next;
+            continue;
+        }
+        // 删除携带 i 的条目前，把工作表编号转交给依赖它的后继条目。
+        if (sheetAttr && next && std::strcmp(localName(next.name()), "c") == 0 &&
+            !next.attribute("i")) {
+            pugi::xml_node successor = next;
+            successor.append_attribute("i").set_value(currentSheet);
+        }
+        chain.remove_child(c);
+        removed = true;
+        c = next;
+    }
+    if (!removed) {
+        return true;
+    }
+    if (!empty) {
+        replacePart(chainPath, saveXml(chainDoc));
+        return true;
+    }
+
+    // 空的 calcChain 不合法：删除部件及工作簿对它的关系，Override 在 write 时一并去掉。
+    const std::string workbookRels = XLSXPackage::relsPathFor(m_package.workbookPath());
+    pugi::xml_document relsDoc;
+    if (!loadPart(workbookRels, relsDoc)) {
+        return false;
+    }
+    pugi::xml_node relRoot = relsDoc.document_element();
+    for (pugi::xml_node rel = relRoot.first_child(); rel;) {
+        const pugi::xml_node next = rel.next_sibling();
+        if (endsWith(rel.attribute("Type").as_string(), "/calcChain")) {
+            relRoot.remove_child(rel);
+        }
+        rel = next;
+    }
+    replacePart(workbookRels, saveXml(relsDoc));
+    removePart(chainPath);
+    return true;
+}
+
+bool PackageRewriter::removePictures(int sheetIndex, const std::set<std::pair<int, int>>& cells) {
+    const std::string drawing = m_package.drawingPath(sheetIndex);
+    if (drawing.empty() || cells.empty()) {
+        return true;
+    }
+    const std::string drawingRels = XLSXPackage::relsPathFor(drawing);
+
+    pugi::xml_document drawingDoc;
+    if (!loadPart(drawing, drawingDoc)) {
+        return false;
+    }
+
+    // 删除锚定在目标单元格的锚点，记录其引用的关系 Id。
+    std::unordered_set<std::string> removedIds;
+    bool anchorRemoved = false;
+    pugi::xml_node wsDr = drawingDoc.document_element();
+    for (pugi::xml_node anchor = wsDr.first_child(); anchor;) {
+        const pugi::xml_node next = anchor.next_sibling();
+        const char* anchorName = localName(anchor.name());
+        if (std::strcmp(anchorName, "twoCellAnchor") == 0 ||
+            std::strcmp(anchorName, "oneCellAnchor") == 0) {
+            const pugi::xml_node from = childByLocalName(anchor, "from");
+            const int row = childByLocalName(from, "row").text().as_int(-1) + 1;
+            const int col = childByLocalName(from, "col").text().as_int(-1) + 1;
+            if (from && cells.count({row, col}) > 0) {
+                collectRelationshipIds(anchor, removedIds);
+                wsDr.remove_child(anchor);
+                anchorRemoved = true;
+            }
+        }
+        anchor = next;
+    }
+    if (!anchorRemoved) {
+        return true;
+    }
+    replacePart(drawing, saveXml(drawingDoc));
+
+    // 同一图片多次出现时 Excel 复用同一个 rId：仍被保留的锚点引用的关系不能删除。
+    std::unordered_set<std::string> survivingIds;
+    collectRelationshipIds(wsDr, survivingIds);
+    for (const auto& id : survivingIds) {
+        removedIds.erase(id);
+    }
+    if (removedIds.empty()) {
+        return true;
+    }
+
+    pugi::xml_document relsDoc;
+    if (!loadPart(drawingRels, relsDoc)) {
+        return false;
+    }
+    std::unordered_set<std::string> candidates;
+    pugi::xml_node relRoot = relsDoc.document_element();
+    for (pugi::xml_node rel = relRoot.first_child(); rel;) {
+        const pugi::xml_node next = rel.next_sibling();
+        if (removedIds.count(rel.attribute("Id").as_string()) > 0) {
+            if (std::strcmp(rel.attribute("TargetMode").as_string(), "External") != 0) {
+                candidates.insert(
+                    XLSXPackage::resolveTarget(drawing, rel.attribute("Target").as_string()));
+            }
+            relRoot.remove_child(rel);
+        }
+        rel = next;
+    }
+    replacePart(drawingRels, saveXml(relsDoc));
+
+    // 图片可能被其他 drawing 共享：扫描包内全部关系，只删除已无人引用的部件。
+    for (const auto& entry : m_package.archive().entries()) {
+        if (candidates.empty()) {
+            break;
+        }
+        const size_t relsDir = entry.name.rfind("_rels/");
+        if (!endsWith(entry.name, ".rels") || relsDir == std::string::npos) {
+            continue;
+        }
+        const std::string sourcePart =
+            entry.name.substr(0, relsDir) +
+            entry.name.substr(relsDir + 6, entry.name.size() - relsDir - 6 - 5);
+        pugi::xml_document doc;
+        if (!loadPart(entry.name, doc)) {
+            continue;
+        }
+        for (pugi::xml_node rel = doc.document_element().first_child(); rel;
+             rel = rel.next_sibling()) {
+            if (std::strcmp(rel.attribute("TargetMode").as_string(), "External") != 0) {
+                candidates.erase(
+                    XLSXPackage::resolveTarget(sourcePart, rel.attribute("Target").as_string()));
+            }
+        }
+    }
+    for (const auto& media : candidates) {
+        removePart(media);
+    }
+    return true;
+}
+
+bool PackageRewriter::contentTypesWithoutRemoved(std::string& out) const {
+    pugi::xml_document doc;
+    if (!loadPart(kContentTypesPath, doc)) {
+        return false;
+    }
+    pugi::xml_node types = doc.document_element();
+    for (pugi::xml_node node = types.first_child(); node;) {
+        const pugi::xml_node next = node.next_sibling();
+        const std::string partName = node.attribute("PartName").as_string();
+        if (std::strcmp(localName(node.name()), "Override") == 0 && !partName.empty() &&
+            m_removed.count(partName.substr(1)) > 0) {
+            types.remove_child(node);
+        }
+        node = next;
+    }
+    out = saveXml(doc);
+    return true;
+}
+
+bool PackageRewriter::write(const std::string& targetPath) const {
+    const ZipArchive& archive = m_package.archive();
+    if (!archive.isOpen() || targetPath == archive.path()) {
+        return false;
+    }
+    ZipWriter writer;
+    if (!writer.open(targetPath)) {
+        return false;
+    }
+    for (const auto& entry : archive.entries()) {
+        if (m_removed.count(entry.name) > 0) {
+            continue;
+        }
+        bool ok = false;
+        auto replaced = m_replaced.find(entry.name);
+        if (replaced != m_replaced.end()) {
+            ok = writer.add(entry.name, replaced->second);
+        } else if (!m_removed.empty() && entry.name == kContentTypesPath) {
+            std::string contentTypes;
+            ok = contentTypesWithoutRemoved(contentTypes) &&
+                 writer.add(entry.name, contentTypes);
+        } else {
+            ok = writer.addRaw(archive, entry);
+        }
+        if (!ok) {
+            writer.abort();
+            return false;
+        }
+    }
+    return writer.finish();
+}
+
+}  // namespace cc::neolux::fem::xlsxeditor
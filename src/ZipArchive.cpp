@@ -0,0 +1,341 @@
+#include "cc/neolux/fem/xlsxeditor/ZipArchive.hpp"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <new>
+
+namespace {
+constexpr uint32_t kLocalHeaderSignature = 0x04034b50;
+constexpr uint32_t kCentralHeaderSignature = 0x02014b50;
+constexpr uint32_t kEndOfCentralDirSignature = 0x06054b50;
+constexpr uint32_t kZip64EndOfCentralDirSignature = 0x06064b50;
+constexpr uint32_t kZip64LocatorSignature = 0x07064b50;
+constexpr uint16_t kZip64ExtraFieldId = 0x0001;
+constexpr size_t kEndOfCentralDirSize = 22;
+constexpr size_t kZip64LocatorSize = 20;
+constexpr size_t kCentralHeaderSize = 46;
+constexpr size_t kLocalHeaderSize = 30;
+constexpr size_t kMaxCommentSize = 0xFFFF;
+constexpr uint16_t kMethodStored = 0;
+constexpr uint16_t kMethodDeflate = 8;
+// 原始 deflate 流的压缩比上限约为 1032:1，超出说明中央目录中的尺寸不可信。
+constexpr uint64_t kMaxDeflateRatio = 1032;
+// zlib 的 avail_in/avail_out 与 crc32 的长度参数都是 uInt，超大条目按此分块。
+constexpr size_t kZlibChunkSize = std::numeric_limits<uInt>::max();
+
+uint16_t readU16(const char* p) {
+    const auto* u = reinterpret_cast<const unsigned char*>(p);
+    return static_cast<uint16_t>(u[0] | (u[1] << 8));
+}
+
+uint32_t readU32(const char* p) {
+    const auto* u = reinterpret_cast<const unsigned char*>(p);
+    return static_cast<uint32_t>(u[0]) | (static_cast<uint32_t>(u[1]) << 8) |
+           (static_cast<uint32_t>(u[2]) << 16) | (static_cast<uint32_t>(u[3]) << 24);
+}
+
+uint64_t readU64(const char* p) {
+    return static_cast<uint64_t>(readU32(p)) | (static_cast<uint64_t>(readU32(p + 4)) << 32);
+}
+
+bool readAt(std::ifstream& file, uint64_t offset, char* dst, size_t size) {
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+    if (!file) {
+        return false;
+    }
+    file.read(dst, static_cast<std::streamsize>(size));
+    return static_cast<size_t>(file.gcount()) == size;
+}
+
+uint32_t crc32Of(const char* data, size_t size) {
+    uLong crc = crc32(0L, Z_NULL, 0);
+    while (size > 0) {
+        const uInt chunk = static_cast<uInt>(std::min(size, kZlibChunkSize));
+        crc = crc32(crc, reinterpret_cast<const Bytef*>(data), chunk);
+        data += chunk;
+        size -= chunk;
+    }
+    return static_cast<uint32_t>(crc);
+}
+
+/** @brief 将原始 deflate 流解压到预先分配好的 out，要求恰好填满。 */
+bool inflateRaw(const std::string& raw, std::string& out) {
+    z_stream stream{};
+    // 负的窗口位数表示 ZIP 中的原始 deflate 流（无 zlib 头尾）。
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+        return false;
+    }
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(raw.data()));
+    stream.next_out = reinterpret_cast<Bytef*>(out.data());
+    size_t inLeft = raw.size();
+    size_t outLeft = out.size();
+    int ret = Z_OK;
+    while (ret == Z_OK) {
+        if (stream.avail_in == 0 && inLeft > 0) {
+            stream.avail_in = static_cast<uInt>(std::min(inLeft, kZlibChunkSize));
+            inLeft -= stream.avail_in;
+        }
+        if (stream.avail_out == 0 && outLeft > 0) {
+            stream.avail_out = static_cast<uInt>(std::min(outLeft, kZlibChunkSize));
+            outLeft -= stream.avail_out;
+        }
+        // 输入耗尽或输出已满仍未结束时返回 Z_BUF_ERROR，循环随之结束。
+        ret = inflate(&stream, Z_NO_FLUSH);
+    }
+    // total_out 在部分平台上是 32 位，以指针位置计算实际产出。
+    const size_t produced = static_cast<size_t>(stream.next_out -
+                                                reinterpret_cast<Bytef*>(out.data()));
+    inflateEnd(&stream);
+    return ret == Z_STREAM_END && produced == out.size();
+}
+
+/** @brief 用 Zip64 扩展字段覆盖 32 位字段中的占位值（0xFFFFFFFF）。 */
+void applyZip64Extra(const char* extra, size_t extraLen, uint32_t rawUncompressed,
+                     uint32_t rawCompressed, uint32_t rawOffset,
+                     cc::neolux::fem::xlsxeditor::ZipArchive::Entry& entry) {
+    size_t pos = 0;
+    while (pos + 4 <= extraLen) {
+        const uint16_t id = readU16(extra + pos);
+        const uint16_t size = readU16(extra + pos + 2);
+        const char* data = extra + pos + 4;
+        if (pos + 4 + size > extraLen) {
+            return;
+        }
+        if (id == kZip64ExtraFieldId) {
+            size_t field = 0;
+            if (rawUncompressed == 0xFFFFFFFFu && field + 8 <= size) {
+                entry.uncompressedSize = readU64(data + field);
+                field += 8;
+            }
+            if (rawCompressed == 0xFFFFFFFFu && field + 8 <= size) {
+                entry.compressedSize = readU64(data + field);
+                field += 8;
+            }
+            if (rawOffset == 0xFFFFFFFFu && field + 8 <= size) {
+                entry.localHeaderOffset = readU64(data + field);
+            }
+            return;
+        }
+        pos += 4 + size;
+    }
+}
+}  // namespace
+
+namespace cc::neolux::fem::xlsxeditor {
+
+bool ZipArchive::open(const std::string& path) {
+    close();
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    file.seekg(0, std::ios::end);
+    const uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    if (fileSize < kEndOfCentralDirSize) {
+        return false;
+    }
+
+    // 从文件尾部向前查找 EOCD 记录（其后可能跟随最长 64KB 的注释）。
+    const uint64_t tailSize =
+        std::min<uint64_t>(fileSize, kEndOfCentralDirSize + kMaxCommentSize);
+    std::string tail(static_cast<size_t>(tailSize), '\0');
+    if (!readAt(file, fileSize - tailSize, tail.data(), tail.size())) {
+        return false;
+    }
+    size_t eocdPos = std::string::npos;
+    for (size_t i = tail.size() - kEndOfCentralDirSize + 1; i-- > 0;) {
+        if (readU32(tail.data() + i) == kEndOfCentralDirSignature) {
+            eocdPos = i;
+            break;
+        }
+    }
+    if (eocdPos == std::string::npos) {
+        return false;
+    }
+
+    const char* eocd = tail.data() + eocdPos;
+    uint64_t entryCount = readU16(eocd + 10);
+    uint64_t cdSize = readU32(eocd + 12);
+    uint64_t cdOffset = readU32(eocd + 16);
+
+    // Zip64：EOCD 中的占位值需要从 Zip64 EOCD 记录中取真实值。
+    if (entryCount == 0xFFFF || cdSize == 0xFFFFFFFFu || cdOffset == 0xFFFFFFFFu) {
+        const uint64_t eocdOffset = fileSize - tailSize + eocdPos;
+        if (eocdOffset < kZip64LocatorSize) {
+            return false;
+        }
+        char locator[kZip64LocatorSize];
+        if (!readAt(file, eocdOffset - kZip64LocatorSize, locator, sizeof(locator)) ||
+            readU32(locator) != kZip64LocatorSignature) {
+            return false;
+        }
+        char zip64Eocd[56];
+        if (!readAt(file, readU64(locator + 8), zip64Eocd, sizeof(zip64Eocd)) ||
+            readU32(zip64Eocd) != kZip64EndOfCentralDirSignature) {
+            return false;
+        }
+        entryCount = readU64(zip64Eocd + 32);
+        cdSize = readU64(zip64Eocd + 40);
+        cdOffset = readU64(zip64Eocd + 48);
+    }
+
+    if (cdOffset + cdSize > fileSize) {
+        return false;
+    }
+    m_centralDirectory.resize(static_cast<size_t>(cdSize));
+    if (!readAt(file, cdOffset, m_centralDirectory.data(), m_centralDirectory.size())) {
+        m_centralDirectory.clear();
+        return false;
+    }
+
+    m_entries.reserve(static_cast<size_t>(entryCount));
+    size_t pos = 0;
+    const char* cd = m_centralDirectory.data();
+    for (uint64_t i = 0; i < entryCount; ++i) {
+        if (pos + kCentralHeaderSize > m_centralDirectory.size() ||
+            readU32(cd + pos) != kCentralHeaderSignature) {
+            close();
+            return false;
+        }
+        const char* h = cd + pos;
+        const uint16_t nameLen = readU16(h + 28);
+        const uint16_t extraLen = readU16(h + 30);
+        const uint16_t commentLen = readU16(h + 32);
+        if (pos + kCentralHeaderSize + nameLen + extraLen + commentLen >
+            m_centralDirectory.size()) {
+            close();
+            return false;
+        }
+
+        Entry entry;
+        entry.versionMadeBy = readU16(h + 4);
+        entry.versionNeeded = readU16(h + 6);
+        entry.flags = readU16(h + 8);
+        entry.method = readU16(h + 10);
+        entry.modTime = readU16(h + 12);
+        entry.modDate = readU16(h + 14);
+        entry.crc32 = readU32(h + 16);
+        const uint32_t rawCompressed = readU32(h + 20);
+        const uint32_t rawUncompressed = readU32(h + 24);
+        entry.externalAttributes = readU32(h + 38);
+        const uint32_t rawOffset = readU32(h + 42);
+        entry.compressedSize = rawCompressed;
+        entry.uncompressedSize = rawUncompressed;
+        entry.localHeaderOffset = rawOffset;
+        entry.name.assign(h + kCentralHeaderSize, nameLen);
+        applyZip64Extra(h + kCentralHeaderSize + nameLen, extraLen, rawUncompressed,
+                        rawCompressed, rawOffset, entry);
+
+        m_indexByName.emplace(entry.name, m_entries.size());
+        m_entries.push_back(std::move(entry));
+        pos += kCentralHeaderSize + nameLen + extraLen + commentLen;
+    }
+
+    m_path = path;
+    m_open = true;
+    return true;
+}
+
+void ZipArchive::close() {
+    m_open = false;
+    m_path.clear();
+    m_entries.clear();
+    m_indexByName.clear();
+    m_centralDirectory.clear();
+}
+
+const ZipArchive::Entry* ZipArchive::find(const std::string& name) const {
+    auto it = m_indexByName.find(name);
+    return it == m_indexByName.end() ? nullptr : &m_entries[it->second];
+}
+
+bool ZipArchive::read(const std::string& name, std::string& out) const {
+    const Entry* entry = find(name);
+    return entry != nullptr && read(*entry, out);
+}
+
+bool ZipArchive::rawDataOffset(const Entry& entry, uint64_t& offset) const {
+    if (!m_open) {
+        return false;
+    }
+    std::ifstream file(m_path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    // 本地头中的文件名与扩展字段长度可能与中央目录不同，需以本地头为准定位数据。
+    char local[kLocalHeaderSize];
+    if (!readAt(file, entry.localHeaderOffset, local, sizeof(local)) ||
+        readU32(local) != kLocalHeaderSignature) {
+        return false;
+    }
+    offset = entry.localHeaderOffset + kLocalHeaderSize + readU16(local + 26) + readU16(local + 28);
+    return true;
+}
+
+bool ZipArchive::readRaw(const Entry& entry, std::string& out) const {
+    out.clear();
+    uint64_t dataOffset = 0;
+    if (!rawDataOffset(entry, dataOffset)) {
+        return false;
+    }
+    if (entry.compressedSize > out.max_size()) {
+        return false;
+    }
+    std::ifstream file(m_path, std::ios::binary);
+    try {
+        out.resize(static_cast<size_t>(entry.compressedSize));
+    } catch (const std::bad_alloc&) {
+        return false;
+    }
+    if (!out.empty() && !readAt(file, dataOffset, out.data(), out.size())) {
+        out.clear();
+        return false;
+    }
+    return true;
+}
+
+bool ZipArchive::read(const Entry& entry, std::string& out) const {
+    std::string raw;
+    if (!readRaw(entry, raw)) {
+        return false;
+    }
+
+    if (entry.method == kMethodStored) {
+        if (raw.size() != entry.uncompressedSize) {
+            return false;
+        }
+        out = std::move(raw);
+    } else if (entry.method == kMethodDeflate) {
+        // 解压缓冲区按中央目录的尺寸一次分配，先排除不可能的尺寸，避免在加载线程上抛出 bad_alloc。
+        if (entry.uncompressedSize / kMaxDeflateRatio > raw.size() ||
+            entry.uncompressedSize > out.max_size()) {
+            return false;
+        }
+        try {
+            out.assign(static_cast<size_t>(entry.uncompressedSize), '\0');
+        } catch (const std::bad_alloc&) {
+            out.clear();
+            return false;
+        }
+        if (!inflateRaw(raw, out)) {
+            out.clear();
+            return false;
+        }
+    } else {
+        return false;
+    }
+
+    if (crc32Of(out.data(), out.size()) != entry.crc32) {
+        out.clear();
+        return false;
+    }
+    return true;
+}
+
+}  // namespace cc::neolux::fem::xlsxeditor
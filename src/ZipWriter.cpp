@@ -0,0 +1,321 @@
+#include "cc/neolux/fem/xlsxeditor/ZipWriter.hpp"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <limits>
+
+namespace {
+constexpr uint32_t kLocalHeaderSignature = 0x04034b50;
+constexpr uint32_t kCentralHeaderSignature = 0x02014b50;
+constexpr uint32_t kEndOfCentralDirSignature = 0x06054b50;
+constexpr uint32_t kZip64EndOfCentralDirSignature = 0x06064b50;
+constexpr uint32_t kZip64LocatorSignature = 0x07064b50;
+constexpr uint16_t kZip64ExtraFieldId = 0x0001;
+constexpr uint16_t kVersionDefault = 20;
+constexpr uint16_t kVersionZip64 = 45;
+constexpr uint16_t kMethodDeflate = 8;
+// 通用标志位 3：大小与 CRC 写在数据之后的描述符中；复制时本地头已写明，需清除。
+constexpr uint16_t kFlagDataDescriptor = 0x0008;
+constexpr uint32_t kMax32 = 0xFFFFFFFFu;
+constexpr size_t kCopyChunkSize = 1 << 20;
+// zlib 的 avail_in/avail_out 与 crc32 的长度参数都是 uInt，超大条目按此分块。
+constexpr size_t kZlibChunkSize = std::numeric_limits<uInt>::max();
+
+void putU16(std::string& out, uint16_t value) {
+    out.push_back(static_cast<char>(value & 0xFF));
+    out.push_back(static_cast<char>((value >> 8) & 0xFF));
+}
+
+void putU32(std::string& out, uint32_t value) {
+    putU16(out, static_cast<uint16_t>(value & 0xFFFF));
+    putU16(out, static_cast<uint16_t>(value >> 16));
+}
+
+void putU64(std::string& out, uint64_t value) {
+    putU32(out, static_cast<uint32_t>(value & kMax32));
+    putU32(out, static_cast<uint32_t>(value >> 32));
+}
+
+uint32_t clamp32(uint64_t value) {
+    return value >= kMax32 ? kMax32 : static_cast<uint32_t>(value);
+}
+
+uint32_t crc32Of(const char* data, size_t size) {
+    uLong crc = crc32(0L, Z_NULL, 0);
+    while (size > 0) {
+        const uInt chunk = static_cast<uInt>(std::min(size, kZlibChunkSize));
+        crc = crc32(crc, reinterpret_cast<const Bytef*>(data), chunk);
+        data += chunk;
+        size -= chunk;
+    }
+    return static_cast<uint32_t>(crc);
+}
+
+void currentDosTime(uint16_t& dosTime, uint16_t& dosDate) {
+    const std::time_t now = std::time(nullptr);
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &now);
+#else
+    localtime_r(&now, &local);
+#endif
+    dosTime =
+        static_cast<uint16_t>((local.tm_hour << 11) | (local.tm_min << 5) | (local.tm_sec / 2));
+    dosDate = static_cast<uint16_t>(((local.tm_year - 80) << 9) | ((local.tm_mon + 1) << 5) |
+                                    local.tm_mday);
+}
+}  // namespace
+
+namespace cc::neolux::fem::xlsxeditor {
+
+ZipWriter::~ZipWriter() {
+    abort();
+}
+
+bool ZipWriter::open(const std::string& path) {
+    abort();
+    m_out.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_out) {
+        return false;
+    }
+    m_path = path;
+    m_offset = 0;
+    m_failed = false;
+    return true;
+}
+
+bool ZipWriter::add(const std::string& name, const std::string& data) {
+    if (!isOpen() || m_failed) {
+        return false;
+    }
+
+    z_stream stream{};
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+        m_failed = true;
+        return false;
+    }
+    // 输入与输出都按 uInt 分块交给 zlib，输出缓冲区不足时倍增，超过 4 GiB 的条目同样完整压缩。
+    std::string compressed(std::min(data.size(), kCopyChunkSize) + 64, '\0');
+    size_t produced = 0;
+    size_t inLeft = data.size();
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    int ret = Z_OK;
+    while (ret == Z_OK) {
+        if (stream.avail_in == 0 && inLeft > 0) {
+            stream.avail_in = static_cast<uInt>(std::min(inLeft, kZlibChunkSize));
+            inLeft -= stream.avail_in;
+        }
+        if (produced == compressed.size()) {
+            compressed.resize(compressed.size() * 2);
+        }
+        const uInt room = static_cast<uInt>(std::min(compressed.size() - produced, kZlibChunkSize));
+        stream.next_out = reinterpret_cast<Bytef*>(compressed.data() + produced);
+        stream.avail_out = room;
+        ret = deflate(&stream, inLeft == 0 ? Z_FINISH : Z_NO_FLUSH);
+        produced += room - stream.avail_out;
+    }
+    compressed.resize(produced);
+    deflateEnd(&stream);
+    if (ret != Z_STREAM_END) {
+        m_failed = true;
+        return false;
+    }
+
+    ZipArchive::Entry entry;
+    entry.name = name;
+    entry.method = kMethodDeflate;
+    currentDosTime(entry.modTime, entry.modDate);
+    entry.crc32 = crc32Of(data.data(), data.size());
+    entry.compressedSize = compressed.size();
+    entry.uncompressedSize = data.size();
+    if (!writeLocalHeader(entry) || !writeBytes(compressed.data(), compressed.size())) {
+        return false;
+    }
+    m_entries.push_back(std::move(entry));
+    return true;
+}
+
+bool ZipWriter::addRaw(const ZipArchive& source, const ZipArchive::Entry& entry) {
+    if (!isOpen() || m_failed) {
+        return false;
+    }
+    uint64_t dataOffset = 0;
+    if (!source.rawDataOffset(entry, dataOffset)) {
+        m_failed = true;
+        return false;
+    }
+    std::ifstream in(source.path(), std::ios::binary);
+    in.seekg(static_cast<std::streamoff>(dataOffset), std::ios::beg);
+    if (!in) {
+        m_failed = true;
+        return false;
+    }
+
+    ZipArchive::Entry copy = entry;
+    copy.flags &= static_cast<uint16_t>(~kFlagDataDescriptor);
+    if (!writeLocalHeader(copy)) {
+        return false;
+    }
+    std::string buffer(kCopyChunkSize, '\0');
+    uint64_t remaining = entry.compressedSize;
+    while (remaining > 0) {
+        const size_t chunk = static_cast<size_t>(std::min<uint64_t>(remaining, buffer.size()));
+        in.read(buffer.data(), static_cast<std::streamsize>(chunk));
+        if (static_cast<size_t>(in.gcount()) != chunk || !writeBytes(buffer.data(), chunk)) {
+            m_failed = true;
+            return false;
+        }
+        remaining -= chunk;
+    }
+    m_entries.push_back(std::move(copy));
+    return true;
+}
+
+bool ZipWriter::finish() {
+    if (!isOpen() || m_failed) {
+        abort();
+        return false;
+    }
+
+    const uint64_t cdOffset = m_offset;
+    std::string cd;
+    for (const auto& entry : m_entries) {
+        // Zip64 扩展字段按 原始大小、压缩大小、本地头偏移 的顺序只写入溢出的字段。
+        std::string extra;
+        if (entry.uncompressedSize >= kMax32) {
+            putU64(extra, entry.uncompressedSize);
+        }
+        if (entry.compressedSize >= kMax32) {
+            putU64(extra, entry.compressedSize);
+        }
+        if (entry.localHeaderOffset >= kMax32) {
+            putU64(extra, entry.localHeaderOffset);
+        }
+        std::string zip64;
+        if (!extra.empty()) {
+            putU16(zip64, kZip64ExtraFieldId);
+            putU16(zip64, static_cast<uint16_t>(extra.size()));
+            zip64 += extra;
+        }
+
+        putU32(cd, kCentralHeaderSignature);
+        putU16(cd, entry.versionMadeBy);
+        putU16(cd, zip64.empty() ? entry.versionNeeded : kVersionZip64);
+        putU16(cd, entry.flags);
+        putU16(cd, entry.method);
+        putU16(cd, entry.modTime);
+        putU16(cd, entry.modDate);
+        putU32(cd, entry.crc32);
+        putU32(cd, clamp32(entry.compressedSize));
+        putU32(cd, clamp32(entry.uncompressedSize));
+        putU16(cd, static_cast<uint16_t>(entry.name.size()));
+        putU16(cd, static_cast<uint16_t>(zip64.size()));
+        putU16(cd, 0);  // 注释长度
+        putU16(cd, 0);  // 起始磁盘号
+        putU16(cd, 0);  // 内部属性
+        putU32(cd, entry.externalAttributes);
+        putU32(cd, clamp32(entry.localHeaderOffset));
+        cd += entry.name;
+        cd += zip64;
+    }
+
+    const uint64_t cdSize = cd.size();
+    const uint64_t count = m_entries.size();
+    std::string tail;
+    if (count >= 0xFFFF || cdSize >= kMax32 || cdOffset >= kMax32) {
+        const uint64_t zip64EocdOffset = cdOffset + cdSize;
+        putU32(tail, kZip64EndOfCentralDirSignature);
+        putU64(tail, 44);  // 记录剩余长度
+        putU16(tail, kVersionZip64);
+        putU16(tail, kVersionZip64);
+        putU32(tail, 0);
+        putU32(tail, 0);
+        putU64(tail, count);
+        putU64(tail, count);
+        putU64(tail, cdSize);
+        putU64(tail, cdOffset);
+
+        putU32(tail, kZip64LocatorSignature);
+        putU32(tail, 0);
+        putU64(tail, zip64EocdOffset);
+        putU32(tail, 1);
+    }
+    putU32(tail, kEndOfCentralDirSignature);
+    putU16(tail, 0);
+    putU16(tail, 0);
+    putU16(tail, static_cast<uint16_t>(count >= 0xFFFF ? 0xFFFF : count));
+    putU16(tail, static_cast<uint16_t>(count >= 0xFFFF ? 0xFFFF : count));
+    putU32(tail, clamp32(cdSize));
+    putU32(tail, clamp32(cdOffset));
+    putU16(tail, 0);
+
+    if (!writeBytes(cd.data(), cd.size()) || !writeBytes(tail.data(), tail.size())) {
+        abort();
+        return false;
+    }
+    m_out.close();
+    if (!m_out) {
+        abort();
+        return false;
+    }
+    m_entries.clear();
+    m_path.clear();
+    return true;
+}
+
+void ZipWriter::abort() {
+    if (m_out.is_open()) {
+        m_out.close();
+    }
+    if (!m_path.empty()) {
+        std::remove(m_path.c_str());
+        m_path.clear();
+    }
+    m_entries.clear();
+    m_offset = 0;
+}
+
+bool ZipWriter::writeLocalHeader(ZipArchive::Entry& entry) {
+    entry.localHeaderOffset = m_offset;
+    // 本地头的 Zip64 扩展字段必须同时包含原始与压缩大小。
+    const bool zip64 = entry.uncompressedSize >= kMax32 || entry.compressedSize >= kMax32;
+    std::string header;
+    putU32(header, kLocalHeaderSignature);
+    putU16(header, zip64 ? kVersionZip64 : std::max(entry.versionNeeded, kVersionDefault));
+    putU16(header, entry.flags);
+    putU16(header, entry.method);
+    putU16(header, entry.modTime);
+    putU16(header, entry.modDate);
+    putU32(header, entry.crc32);
+    putU32(header, zip64 ? kMax32 : static_cast<uint32_t>(entry.compressedSize));
+    putU32(header, zip64 ? kMax32 : static_cast<uint32_t>(entry.uncompressedSize));
+    putU16(header, static_cast<uint16_t>(entry.name.size()));
+    putU16(header, zip64 ? 20 : 0);
+    header += entry.name;
+    if (zip64) {
+        putU16(header, kZip64ExtraFieldId);
+        putU16(header, 16);
+        putU64(header, entry.uncompressedSize);
+        putU64(header, entry.compressedSize);
+    }
+    if (zip64) {
+        entry.versionNeeded = kVersionZip64;
+    }
+    return writeBytes(header.data(), header.size());
+}
+
+bool ZipWriter::writeBytes(const char* data, size_t size) {
+    m_out.write(data, static_cast<std::streamsize>(size));
+    if (!m_out) {
+        m_failed = true;
+        return false;
+    }
+    m_offset += size;
+    return true;
+}
+
+}  // namespace cc::neolux::fem::xlsxeditor
@@ -0,0 +1,400 @@
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentMap>
+#include <algorithm>
+#include <optional>
+
+#include "cc/neolux/fem/xlsxeditor/XLSXDocument.hpp"
+
+using namespace cc::neolux::fem::xlsxeditor;
+
+namespace {
+
+/** @brief 清单中的一个工作簿任务。 */
+struct BatchJob {
+    QString workbook;
+    QString sheet;
+    QString range;
+    bool dryRun;
+    QVector<QPair<int, int>> deleteCells;  // (row, col)，1-based
+    QVector<int> deleteRows;
+    QVector<int> deleteColumns;
+    QVector<QPair<QPair<int, int>, QString>> descriptions;  // ((row, col), 新描述)
+    AxisMapping axis;
+    QVector<MarkRule> rules;
+};
+
+/** @brief 单个工作簿的处理结果。 */
+struct BatchResult {
+    bool ok = false;
+    QString message;
+    QString targetPath;
+    int pictures = 0;
+    int deleted = 0;
+    int unmatched = 0;  // 清单中指向范围外或无图片单元格的标记数
+    qint64 sourceBytes = 0;
+    qint64 loadMs = 0;
+    qint64 markMs = 0;
+    qint64 saveMs = 0;
+    QVector<StageTiming> timings;  // --profile 时的分阶段计时
+};
+
+QMutex g_outputMutex;
+
+void printLine(const QString& line) {
+    QMutexLocker locker(&g_outputMutex);
+    QTextStream out(stdout);
+    out << line << Qt::endl;
+}
+
+bool parseCellRef(const QString& ref, int& row, int& col) {
+    static const QRegularExpression pattern(QStringLiteral("^\\s*([A-Za-z]+)(\\d+)\\s*$"));
+    const QRegularExpressionMatch match = pattern.match(ref);
+    if (!match.hasMatch()) {
+        return false;
+    }
+    col = XLSXDocument::columnNumber(match.captured(1));
+    row = match.captured(2).toInt();
+    return row > 0 && col > 0;
+}
+
+/** @brief 列可写作字母（"C"）或 1-based 列号。 */
+int parseColumn(const QJsonValue& value) {
+    if (value.isDouble()) {
+        return value.toInt();
+    }
+    return XLSXDocument::columnNumber(value.toString());
+}
+
+/** @brief 比较用的路径键：存在时解析符号链接，不区分大小写的文件系统上统一大小写。 */
+QString pathKey(const QString& path) {
+    const QFileInfo info(path);
+    const QString resolved = info.exists() ? info.canonicalFilePath() : info.absoluteFilePath();
+#if defined(Q_OS_WIN) || defined(Q_OS_MACOS)
+    return resolved.toCaseFolded();
+#else
+    return resolved;
+#endif
+}
+
+/**
+ * @brief 解析清单。
+ *
+ * 格式：
+ * {
+ *   "dryRun": true,
+ *   "jobs": [{"workbook": "a.xlsx", "sheet": "S1", "range": "B:K,7:34",
+ *             "dryRun": false, "delete": ["C7"], "deleteRows": [8],
+ *             "deleteColumns": ["E"], "descriptions": {"C8": "text"},
+ *             "axis": {"doseCenter": 20, "doseStep": 0.5, "focusCenter": 0,
+ *                      "focusStep": 0.05},
+ *             "rules": ["desc ~ \"NG\" or value > 60"]}]
+ * }
+ * 相对路径以清单所在目录为基准。模式优先级：任务内的 dryRun > 命令行 --dry-run/--real-delete
+ * > 清单顶层的 dryRun > 默认 dry-run。
+ * 任务并行执行，同一工作簿出现两次、或一个任务的源文件是另一个任务的保存目标时拒绝整个清单，
+ * 否则两个任务会同时写同一目标，后完成的一方覆盖另一方的标记。
+ */
+std::optional<QVector<BatchJob>> parseManifest(const QString& path,
+                                               std::optional<bool> commandLineDryRun,
+                                               QString& error) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = QStringLiteral("cannot open manifest: %1").arg(path);
+        return std::nullopt;
+    }
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+        error = QStringLiteral("invalid manifest: %1").arg(parseError.errorString());
+        return std::nullopt;
+    }
+
+    const QJsonObject root = doc.object();
+    const QDir baseDir = QFileInfo(path).absoluteDir();
+    const bool dryRun =
+        commandLineDryRun.value_or(root.value(QStringLiteral("dryRun")).toBool(true));
+    QVector<BatchJob> jobs;
+    QHash<QString, int> pathOwners;  // 源文件与保存目标 -> 任务序号
+    const QJsonArray jobArray = root.value(QStringLiteral("jobs")).toArray();
+    for (int i = 0; i < jobArray.size(); ++i) {
+        const QJsonObject object = jobArray[i].toObject();
+        BatchJob job;
+        const QString workbook = object.value(QStringLiteral("workbook")).toString();
+        job.workbook = baseDir.absoluteFilePath(workbook);
+        job.sheet = object.value(QStringLiteral("sheet")).toString();
+        job.range = object.value(QStringLiteral("range")).toString();
+        job.dryRun = object.value(QStringLiteral("dryRun")).toBool(dryRun);
+        if (workbook.isEmpty() || job.sheet.isEmpty() || job.range.isEmpty()) {
+            error = QStringLiteral("job %1: workbook, sheet and range are required").arg(i);
+            return std::nullopt;
+        }
+        for (const QString& used :
+             {job.workbook, XLSXDocument::saveTargetPathFor(job.workbook)}) {
+            const auto owner = pathOwners.constFind(pathKey(used));
+            if (owner != pathOwners.constEnd()) {
+                // 多参数 arg 一次替换，路径中的 % 不会被当作占位符。
+                error = QStringLiteral("job %1: %2 is already used by job %3")
+                            .arg(QString::number(i), QDir::toNativeSeparators(used),
+                                 QString::number(owner.value()));
+                return std::nullopt;
+            }
+        }
+        pathOwners.insert(pathKey(job.workbook), i);
+        pathOwners.insert(pathKey(XLSXDocument::saveTargetPathFor(job.workbook)), i);
+
+        for (const auto& value : object.value(QStringLiteral("delete")).toArray()) {
+            int row = 0;
+            int col = 0;
+            if (!parseCellRef(value.toString(), row, col)) {
+                error = QStringLiteral("job %1: invalid cell %2").arg(i).arg(value.toString());
+                return std::nullopt;
+            }
+            job.deleteCells.append({row, col});
+        }
+        for (const auto& value : object.value(QStringLiteral("deleteRows")).toArray()) {
+            job.deleteRows.append(value.toInt());
+        }
+        for (const auto& value : object.value(QStringLiteral("deleteColumns")).toArray()) {
+            job.deleteColumns.append(parseColumn(value));
+        }
+        const QJsonObject descriptions = object.value(QStringLiteral("descriptions")).toObject();
+        for (auto it = descriptions.constBegin(); it != descriptions.constEnd(); ++it) {
+            int row = 0;
+            int col = 0;
+            if (!parseCellRef(it.key(), row, col)) {
+                error = QStringLiteral("job %1: invalid cell %2").arg(i).arg(it.key());
+                return std::nullopt;
+            }
+            job.descriptions.append({{row, col}, it.value().toString()});
+        }
+        if (object.contains(QStringLiteral("axis"))) {
+            const QJsonObject axis = object.value(QStringLiteral("axis")).toObject();
+            job.axis.enabled = true;
+            job.axis.doseCenter = axis.value(QStringLiteral("doseCenter")).toDouble();
+            job.axis.doseStep = axis.value(QStringLiteral("doseStep")).toDouble();
+            job.axis.focusCenter = axis.value(QStringLiteral("focusCenter")).toDouble();
+            job.axis.focusStep = axis.value(QStringLiteral("focusStep")).toDouble();
+        }
+        // 规则在解析清单时编译，语法错误在处理任何工作簿之前报告。
+        for (const auto& value : object.value(QStringLiteral("rules")).toArray()) {
+            QString ruleError;
+            const std::optional<MarkRule> rule = MarkRule::compile(value.toString(), &ruleError);
+            if (!rule) {
+                error = QStringLiteral("job %1: invalid rule: %2").arg(i).arg(ruleError);
+                return std::nullopt;
+            }
+            job.rules.append(*rule);
+        }
+        jobs.append(job);
+    }
+    return jobs;
+}
+
+/**
+ * @brief 在当前工作线程中处理一个工作簿：阻塞加载、应用标记、阻塞保存。
+ *
+ * 每个任务使用自己的 XLSXDocument，不需要事件循环，多个任务可在不同线程中并行。
+ */
+BatchResult runJob(const BatchJob& job, bool profile) {
+    BatchResult result;
+    result.sourceBytes = QFileInfo(job.workbook).size();
+    QElapsedTimer timer;
+
+    XLSXDocument document(nullptr, job.dryRun);
+    // 批处理的标记来自清单，不回放也不记录审阅者的编辑日志。
+    document.setJournalEnabled(false);
+    // 批处理只需要锚点与描述，不解码图片。
+    document.setPictureDecodingEnabled(false);
+    // 并行任务不写共享的用户级缩略图缓存：这些缩略图不会被显示。
+    document.setThumbnailCacheBudget(0);
+    document.setAxisMapping(job.axis);
+    document.setProfilingEnabled(profile);
+
+    timer.start();
+    const bool loaded = document.load(job.workbook, job.sheet, job.range);
+    result.loadMs = timer.elapsed();
+    result.timings = document.lastLoadTimings();
+    if (!loaded) {
+        result.message = document.lastError();
+        return result;
+    }
+    result.pictures = static_cast<int>(document.entries().size());
+    if (result.pictures == 0) {
+        result.ok = true;
+        result.message = QStringLiteral("no pictures in range, skipped");
+        return result;
+    }
+
+    // 整行/列标记只作用于网格中的项，与表头双击一致；单元格标记可覆盖无图项。
+    timer.restart();
+    const QVector<DataEntry>& entries = document.entries();
+    for (int i = 0; i < entries.size(); ++i) {
+        const DataEntry& entry = entries[i];
+        if (entry.inGrid() &&
+            (job.deleteRows.contains(entry.row) || job.deleteColumns.contains(entry.col))) {
+            document.setDeleted(i, true);
+        }
+    }
+    for (const auto& cell : job.deleteCells) {
+        const int index = document.indexOf(cell.first, cell.second);
+        if (index < 0) {
+            ++result.unmatched;
+            continue;
+        }
+        document.setDeleted(index, true);
+    }
+    for (const auto& rule : job.rules) {
+        document.applyRule(rule, true);
+    }
+    for (const auto& description : job.descriptions) {
+        const int index = document.indexOf(description.first.first, description.first.second);
+        if (index < 0) {
+            ++result.unmatched;
+            continue;
+        }
+        document.setDescription(index, description.second);
+    }
+    result.deleted = document.deletedCount();
+    result.markMs = timer.elapsed();
+
+    timer.restart();
+    result.ok = document.save();
+    result.saveMs = timer.elapsed();
+    result.timings += document.lastSaveTimings();
+    if (result.ok) {
+        result.targetPath = document.saveTargetPath();
+    } else {
+        result.message = document.lastError();
+    }
+    return result;
+}
+
+/** @brief 分阶段计时，每阶段一行，与工作簿结果一起输出以免并行任务的输出交错。 */
+QString formatTimings(const QVector<StageTiming>& timings) {
+    QString text;
+    for (const auto& timing : timings) {
+        text += QStringLiteral("\n    %1 %2 ms  calls=%3 items=%4 bytes=%5")
+                    .arg(timing.name, -20)
+                    .arg(timing.nsecs / 1e6, 9, 'f', 2)
+                    .arg(timing.calls)
+                    .arg(timing.items)
+                    .arg(timing.bytes);
+    }
+    return text;
+}
+
+void printUsage(const char* program) {
+    QTextStream err(stderr);
+    err << "Usage: " << program << " <manifest.json> [options]\n"
+        << "  --dry-run       Mark deleted entries red instead of removing them\n"
+        << "  --real-delete   Remove deleted pictures and descriptions\n"
+        << "  --jobs N        Number of workbooks processed in parallel (default: cores)\n"
+        << "  --profile       Print per-stage timings for each workbook\n"
+        << "A job's dryRun overrides the command line, which overrides the manifest's dryRun.\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QString manifestPath;
+    std::optional<bool> dryRun;  // 未指定时由清单决定
+    int workers = QThread::idealThreadCount();
+    bool profile = false;
+    const QStringList args = QCoreApplication::arguments();
+    for (int i = 1; i < args.size(); ++i) {
+        const QString& arg = args[i];
+        if (arg == QLatin1String("--dry-run")) {
+            dryRun = true;
+        } else if (arg == QLatin1String("--real-delete")) {
+            dryRun = false;
+        } else if (arg == QLatin1String("--profile")) {
+            profile = true;
+        } else if (arg == QLatin1String("--jobs") && i + 1 < args.size()) {
+            workers = args[++i].toInt();
+        } else if (!arg.startsWith(QLatin1String("--")) && manifestPath.isEmpty()) {
+            manifestPath = arg;
+        } else {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    if (manifestPath.isEmpty() || workers <= 0) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    QString error;
+    const std::optional<QVector<BatchJob>> jobs = parseManifest(manifestPath, dryRun, error);
+    if (!jobs) {
+        QTextStream(stderr) << error << Qt::endl;
+        return 2;
+    }
+
+    // 工作簿级并行；每个工作簿内部的图片解码另由解码线程池并行。
+    QThreadPool pool;
+    pool.setMaxThreadCount(workers);
+    QElapsedTimer wall;
+    wall.start();
+    const QList<BatchResult> results =
+        QtConcurrent::blockingMapped(&pool, *jobs, [profile](const BatchJob& job) {
+            const BatchResult result = runJob(job, profile);
+            // 路径与错误信息直接拼接，避免其中的 % 被 arg 当作占位符。
+            printLine((result.ok ? QStringLiteral("[ok]   ") : QStringLiteral("[fail] ")) +
+                      job.workbook +
+                      (job.dryRun ? QStringLiteral("  mode=dry-run")
+                                  : QStringLiteral("  mode=real-delete")) +
+                      QStringLiteral("  pictures=%1 deleted=%2 unmatched=%3  "
+                                     "load=%4ms mark=%5ms save=%6ms  ")
+                          .arg(result.pictures)
+                          .arg(result.deleted)
+                          .arg(result.unmatched)
+                          .arg(result.loadMs)
+                          .arg(result.markMs)
+                          .arg(result.saveMs) +
+                      (result.targetPath.isEmpty() ? result.message
+                                                   : QStringLiteral("-> ") + result.targetPath) +
+                      formatTimings(result.timings));
+            return result;
+        });
+    const double seconds = static_cast<double>(std::max<qint64>(wall.elapsed(), 1)) / 1000.0;
+
+    int succeeded = 0;
+    int pictures = 0;
+    qint64 sourceBytes = 0;
+    qint64 busyMs = 0;
+    for (const auto& result : results) {
+        succeeded += result.ok ? 1 : 0;
+        pictures += result.pictures;
+        sourceBytes += result.sourceBytes;
+        busyMs += result.loadMs + result.markMs + result.saveMs;
+    }
+    printLine(QStringLiteral("%1 workbooks (%2 ok, %3 failed) on %4 workers in %5 s")
+                  .arg(results.size())
+                  .arg(succeeded)
+                  .arg(results.size() - succeeded)
+                  .arg(workers)
+                  .arg(seconds, 0, 'f', 2));
+    printLine(QStringLiteral("throughput: %1 workbooks/s, %2 pictures/s, %3 MB/s; "
+                             "parallel speedup %4x")
+                  .arg(results.size() / seconds, 0, 'f', 2)
+                  .arg(pictures / seconds, 0, 'f', 1)
+                  .arg(sourceBytes / (1024.0 * 1024.0) / seconds, 0, 'f', 1)
+                  .arg(busyMs / 1000.0 / seconds, 0, 'f', 2));
+    return succeeded == results.size() ? 0 : 1;
+}
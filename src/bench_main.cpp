@@ -0,0 +1,648 @@
+#include <QApplication>
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QImageWriter>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QScrollArea>
+#include <QTemporaryDir>
+#include <QTemporaryFile>
+#include <QTextStream>
+#include <QWheelEvent>
+#include <algorithm>
+#include <filesystem>
+#include <map>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "cc/neolux/fem/xlsxeditor/XLSXDocument.hpp"
+#include "cc/neolux/fem/xlsxeditor/XLSXEditor.hpp"
+#include "cc/neolux/fem/xlsxeditor/ZipWriter.hpp"
+
+using namespace cc::neolux::fem::xlsxeditor;
+
+namespace {
+
+constexpr int kFirstPictureRow = 7;  // 与真实 FEM 表一致：表头在第 2 行，图片从第 7 行开始
+constexpr int kFirstPictureCol = 2;  // 第 1 列为行表头
+const char* const kSheetName = "FEM";
+
+/** @brief 合成工作簿的形状与内容参数。 */
+struct WorkbookSpec {
+    int rows = 14;           // 图片行数（每行图片下方一行为描述）
+    int cols = 10;           // 图片列数
+    QSize imageSize{640, 480};
+    QByteArray format = "jpg";  // jpg 或 png
+    double descDensity = 0.8;   // 有描述的图片比例
+    unsigned seed = 1;
+};
+
+/** @brief 基准测试选项。 */
+struct BenchOptions {
+    WorkbookSpec spec;
+    int iterations = 3;
+    int zoomSteps = 5;
+    bool gui = true;
+    bool thumbnailCache = false;
+    QString output;        // 结果 JSON 路径，空时写到标准输出
+    QString generateOnly;  // 非空时只生成工作簿到该路径
+};
+
+std::string xmlEscape(const QString& text) {
+    return text.toHtmlEscaped().toStdString();
+}
+
+std::string cellRef(int row, int col) {
+    return XLSXDocument::columnName(col).toStdString() + std::to_string(row);
+}
+
+/**
+ * @brief 生成一张图片：平滑渐变叠加少量噪声，压缩率接近显微镜照片而不是纯色块。
+ */
+QByteArray makePicture(const WorkbookSpec& spec, int index, std::mt19937& rng) {
+    QImage image(spec.imageSize, QImage::Format_RGB32);
+    std::uniform_int_distribution<int> noise(-12, 12);
+    const int width = image.width();
+    const int height = image.height();
+    for (int y = 0; y < height; ++y) {
+        auto* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            const int r = (x * 255 / width + index * 37) & 0xFF;
+            const int g = (y * 255 / height + index * 11) & 0xFF;
+            const int b = (((x / 8) ^ (y / 8)) + index * 5) & 0xFF;
+            const int n = noise(rng);
+            line[x] = qRgb(std::clamp(r + n, 0, 255), std::clamp(g + n, 0, 255),
+                           std::clamp(b + n, 0, 255));
+        }
+    }
+    QByteArray bytes;
+    QBuffer buffer(&bytes);
+    buffer.open(QIODevice::WriteOnly);
+    QImageWriter writer(&buffer, spec.format);
+    writer.write(image);
+    return bytes;
+}
+
+/** @brief 范围字符串，覆盖全部图片及其下方的描述行。 */
+QString rangeFor(const WorkbookSpec& spec) {
+    const int lastCol = kFirstPictureCol + spec.cols - 1;
+    const int lastRow = kFirstPictureRow + 2 * (spec.rows - 1) + 1;
+    return QStringLiteral("%1:%2,%3:%4")
+        .arg(XLSXDocument::columnName(kFirstPictureCol), XLSXDocument::columnName(lastCol))
+        .arg(kFirstPictureRow)
+        .arg(lastRow);
+}
+
+/**
+ * @brief 生成 FEM 布局的工作簿：第 2 行为 dose 表头，第 1 列为 focus 表头，
+ * 每张图片锚定在一个单元格，其下方单元格为描述（共享字符串，部分带填充样式）。
+ *
+ * 先写入同目录下的临时文件，完整写出后才改名为 path；失败时不留下残缺的工作簿，
+ * path 处已有的文件保持不变。
+ * @param error 失败原因（输出）。
+ */
+bool generateWorkbook(const WorkbookSpec& spec, const QString& path, QString& error) {
+    std::mt19937 rng(spec.seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const std::string ext = spec.format == "png" ? "png" : "jpeg";
+
+    std::vector<std::string> strings;
+    std::map<int, std::string> rowsXml;  // 行号 -> 单元格 XML（按列递增追加）
+    auto addCell = [&rowsXml](int row, const std::string& xml) { rowsXml[row] += xml; };
+
+    for (int c = 0; c < spec.cols; ++c) {
+        const int col = kFirstPictureCol + c;
+        addCell(2, "<c r=\"" + cellRef(2, col) + "\"><v>" + std::to_string(c - spec.cols / 2) +
+                       "</v></c>");
+    }
+
+    std::string drawing =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<xdr:wsDr xmlns:xdr=\"http://schemas.openxmlformats.org/drawingml/2006/"
+        "spreadsheetDrawing\" xmlns:a=\"http://schemas.openxmlformats.org/drawingml/2006/main\" "
+        "xmlns:r=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships\">";
+    std::string drawingRels =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">";
+
+    // 失败时 ZipWriter 与 QTemporaryFile 析构都会删除临时文件。
+    QTemporaryFile partialFile(path + QStringLiteral(".XXXXXX.tmp"));
+    if (!partialFile.open()) {
+        error = QStringLiteral("cannot create a temporary file next to %1").arg(path);
+        return false;
+    }
+    partialFile.close();
+    const std::string partialPath = partialFile.fileName().toStdString();
+    ZipWriter zip;
+    if (!zip.open(partialPath)) {
+        error = QStringLiteral("cannot open %1").arg(partialFile.fileName());
+        return false;
+    }
+
+    int index = 0;
+    for (int r = 0; r < spec.rows; ++r) {
+        const int row = kFirstPictureRow + 2 * r;
+        addCell(row, "<c r=\"" + cellRef(row, 1) + "\"><v>" + std::to_string(r - spec.rows / 2) +
+                         "</v></c>");
+        for (int c = 0; c < spec.cols; ++c, ++index) {
+            const int col = kFirstPictureCol + c;
+            const std::string rid = "rId" + std::to_string(index + 1);
+            const std::string media = "image" + std::to_string(index + 1) + "." + ext;
+            const QByteArray picture = makePicture(spec, index, rng);
+            if (!zip.add("xl/media/" + media, picture.toStdString())) {
+                error = QStringLiteral("cannot write xl/media/%1")
+                            .arg(QString::fromStdString(media));
+                return false;
+            }
+            drawingRels += "<Relationship Id=\"" + rid +
+                           "\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/"
+                           "relationships/image\" Target=\"../media/" +
+                           media + "\"/>";
+            drawing += "<xdr:twoCellAnchor editAs=\"oneCell\"><xdr:from><xdr:col>" +
+                       std::to_string(col - 1) + "</xdr:col><xdr:colOff>0</xdr:colOff><xdr:row>" +
+                       std::to_string(row - 1) +
+                       "</xdr:row><xdr:rowOff>0</xdr:rowOff></xdr:from><xdr:to><xdr:col>" +
+                       std::to_string(col) + "</xdr:col><xdr:colOff>0</xdr:colOff><xdr:row>" +
+                       std::to_string(row) +
+                       "</xdr:row><xdr:rowOff>0</xdr:rowOff></xdr:to><xdr:pic><xdr:nvPicPr>"
+                       "<xdr:cNvPr id=\"" +
+                       std::to_string(index + 2) + "\" name=\"Picture " +
+                       std::to_string(index + 1) +
+                       "\"/><xdr:cNvPicPr/></xdr:nvPicPr><xdr:blipFill><a:blip r:embed=\"" + rid +
+                       "\"/><a:stretch><a:fillRect/></a:stretch></xdr:blipFill><xdr:spPr>"
+                       "<a:prstGeom prst=\"rect\"><a:avLst/></a:prstGeom></xdr:spPr></xdr:pic>"
+                       "<xdr:clientData/></xdr:twoCellAnchor>";
+
+            if (unit(rng) < spec.descDensity) {
+                const bool ng = unit(rng) < 0.2;
+                const QString desc = QStringLiteral("%1 %2")
+                                         .arg(ng ? QStringLiteral("NG") : QStringLiteral("OK"))
+                                         .arg(20.0 + 60.0 * unit(rng), 0, 'f', 1);
+                // 约一成描述带填充样式，覆盖样式读取路径
+                const std::string style = unit(rng) < 0.1 ? " s=\"1\"" : "";
+                addCell(row + 1, "<c r=\"" + cellRef(row + 1, col) + "\"" + style +
+                                     " t=\"s\"><v>" + std::to_string(strings.size()) +
+                                     "</v></c>");
+                strings.push_back(xmlEscape(desc));
+            }
+        }
+    }
+    drawing += "</xdr:wsDr>";
+    drawingRels += "</Relationships>";
+
+    std::string sheet =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<worksheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\" "
+        "xmlns:r=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships\">"
+        "<sheetData>";
+    for (const auto& [row, cells] : rowsXml) {
+        sheet += "<row r=\"" + std::to_string(row) + "\">" + cells + "</row>";
+    }
+    sheet += "</sheetData><drawing r:id=\"rId1\"/></worksheet>";
+
+    std::string sharedStrings =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<sst xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\" count=\"" +
+        std::to_string(strings.size()) + "\" uniqueCount=\"" + std::to_string(strings.size()) +
+        "\">";
+    for (const auto& text : strings) {
+        sharedStrings += "<si><t>" + text + "</t></si>";
+    }
+    sharedStrings += "</sst>";
+
+    const std::string contentTypes =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/content-types\">"
+        "<Default Extension=\"rels\" "
+        "ContentType=\"application/vnd.openxmlformats-package.relationships+xml\"/>"
+        "<Default Extension=\"xml\" ContentType=\"application/xml\"/>"
+        "<Default Extension=\"" +
+        ext + "\" ContentType=\"image/" + ext +
+        "\"/>"
+        "<Override PartName=\"/xl/workbook.xml\" ContentType=\"application/"
+        "vnd.openxmlformats-officedocument.spreadsheetml.sheet.main+xml\"/>"
+        "<Override PartName=\"/xl/worksheets/sheet1.xml\" ContentType=\"application/"
+        "vnd.openxmlformats-officedocument.spreadsheetml.worksheet+xml\"/>"
+        "<Override PartName=\"/xl/drawings/drawing1.xml\" ContentType=\"application/"
+        "vnd.openxmlformats-officedocument.drawing+xml\"/>"
+        "<Override PartName=\"/xl/styles.xml\" ContentType=\"application/"
+        "vnd.openxmlformats-officedocument.spreadsheetml.styles+xml\"/>"
+        "<Override PartName=\"/xl/sharedStrings.xml\" ContentType=\"application/"
+        "vnd.openxmlformats-officedocument.spreadsheetml.sharedStrings+xml\"/>"
+        "</Types>";
+    const std::string rootRels =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+        "<Relationship Id=\"rId1\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/"
+        "relationships/officeDocument\" Target=\"xl/workbook.xml\"/></Relationships>";
+    const std::string workbook =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<workbook xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\" "
+        "xmlns:r=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships\">"
+        "<sheets><sheet name=\"" +
+        std::string(kSheetName) + "\" sheetId=\"1\" r:id=\"rId1\"/></sheets></workbook>";
+    const std::string workbookRels =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+        "<Relationship Id=\"rId1\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/"
+        "relationships/worksheet\" Target=\"worksheets/sheet1.xml\"/>"
+        "<Relationship Id=\"rId2\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/"
+        "relationships/styles\" Target=\"styles.xml\"/>"
+        "<Relationship Id=\"rId3\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/"
+        "relationships/sharedStrings\" Target=\"sharedStrings.xml\"/></Relationships>";
+    const std::string sheetRels =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+        "<Relationship Id=\"rId1\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/"
+        "relationships/drawing\" Target=\"../drawings/drawing1.xml\"/></Relationships>";
+    const std::string styles =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<styleSheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\">"
+        "<fonts count=\"1\"><font><sz val=\"11\"/><name val=\"Calibri\"/></font></fonts>"
+        "<fills count=\"3\"><fill><patternFill patternType=\"none\"/></fill>"
+        "<fill><patternFill patternType=\"gray125\"/></fill>"
+        "<fill><patternFill patternType=\"solid\"><fgColor rgb=\"FFFFFF00\"/>"
+        "<bgColor indexed=\"64\"/></patternFill></fill></fills>"
+        "<borders count=\"1\"><border><left/><right/><top/><bottom/><diagonal/></border>"
+        "</borders><cellStyleXfs count=\"1\"><xf numFmtId=\"0\" fontId=\"0\" fillId=\"0\" "
+        "borderId=\"0\"/></cellStyleXfs><cellXfs count=\"2\"><xf numFmtId=\"0\" fontId=\"0\" "
+        "fillId=\"0\" borderId=\"0\" xfId=\"0\"/><xf numFmtId=\"0\" fontId=\"0\" fillId=\"2\" "
+        "borderId=\"0\" xfId=\"0\" applyFill=\"1\"/></cellXfs></styleSheet>";
+
+    const bool written =
+        zip.add("[Content_Types].xml", contentTypes) && zip.add("_rels/.rels", rootRels) &&
+        zip.add("xl/workbook.xml", workbook) &&
+        zip.add("xl/_rels/workbook.xml.rels", workbookRels) && zip.add("xl/styles.xml", styles) &&
+        zip.add("xl/sharedStrings.xml", sharedStrings) &&
+        zip.add("xl/worksheets/sheet1.xml", sheet) &&
+        zip.add("xl/worksheets/_rels/sheet1.xml.rels", sheetRels) &&
+        zip.add("xl/drawings/drawing1.xml", drawing) &&
+        zip.add("xl/drawings/_rels/drawing1.xml.rels", drawingRels) && zip.finish();
+    if (!written) {
+        error = QStringLiteral("cannot write the workbook parts to %1").arg(partialFile.fileName());
+        return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(partialPath, path.toStdString(), ec);
+    if (ec) {
+        error = QStringLiteral("cannot replace %1: %2")
+                    .arg(path, QString::fromStdString(ec.message()));
+        return false;
+    }
+    return true;
+}
+
+/** @brief 一个测量项的全部样本（毫秒）及最后一次的工作量。 */
+struct Metric {
+    std::vector<double> samples;
+    qint64 items = 0;
+    qint64 bytes = 0;
+};
+
+using Metrics = std::map<QString, Metric>;
+
+void addSample(Metrics& metrics, const QString& name, double ms, qint64 items = 0,
+               qint64 bytes = 0) {
+    Metric& metric = metrics[name];
+    metric.samples.push_back(ms);
+    metric.items = items;
+    metric.bytes = bytes;
+}
+
+/** @brief 把指定阶段的计时记为一个样本；阶段不存在时不记录。 */
+void addStage(Metrics& metrics, const QString& name, const QVector<StageTiming>& timings,
+              const char* stage) {
+    for (const auto& timing : timings) {
+        if (timing.name == QLatin1String(stage)) {
+            addSample(metrics, name, timing.nsecs / 1e6, timing.items, timing.bytes);
+            return;
+        }
+    }
+}
+
+double elapsedMs(const QElapsedTimer& timer) {
+    return timer.nsecsElapsed() / 1e6;
+}
+
+QJsonArray timingsToJson(const QVector<StageTiming>& timings) {
+    QJsonArray array;
+    for (const auto& timing : timings) {
+        array.append(QJsonObject{{QStringLiteral("name"), timing.name},
+                                 {QStringLiteral("ms"), timing.nsecs / 1e6},
+                                 {QStringLiteral("calls"), timing.calls},
+                                 {QStringLiteral("items"), timing.items},
+                                 {QStringLiteral("bytes"), timing.bytes}});
+    }
+    return array;
+}
+
+/**
+ * @brief 无界面部分：加载（打开、枚举、解码、读单元格）、假删除保存与真删除保存。
+ *
+ * 每十项标记一项删除并改写一项描述，使两种保存都有实际的单元格与图片改动。
+ */
+bool runCoreIteration(const BenchOptions& options, const QString& path, Metrics& metrics,
+                      QJsonObject& stages) {
+    XLSXDocument document(nullptr, true);
+    document.setJournalEnabled(false);
+    document.setProfilingEnabled(true);
+    if (!options.thumbnailCache) {
+        document.setThumbnailCacheBudget(0);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    if (!document.load(path, QString::fromLatin1(kSheetName), rangeFor(options.spec))) {
+        QTextStream(stderr) << "load failed: " << document.lastError() << Qt::endl;
+        return false;
+    }
+    const QVector<StageTiming> loadTimings = document.lastLoadTimings();
+    addSample(metrics, QStringLiteral("load"), elapsedMs(timer), document.entries().size(),
+              QFileInfo(path).size());
+    addStage(metrics, QStringLiteral("open"), loadTimings, "load.open");
+    addStage(metrics, QStringLiteral("enumerate"), loadTimings, "load.enumerate");
+    addStage(metrics, QStringLiteral("decode"), loadTimings, "load.decode");
+    addStage(metrics, QStringLiteral("cells"), loadTimings, "load.cells");
+
+    for (int i = 0; i < document.entries().size(); i += 10) {
+        document.setDeleted(i, true);
+        if (i + 1 < document.entries().size()) {
+            document.setDescription(i + 1, QStringLiteral("edited"));
+        }
+    }
+
+    timer.restart();
+    if (!document.save()) {
+        QTextStream(stderr) << "fake-delete save failed: " << document.lastError() << Qt::endl;
+        return false;
+    }
+    const QVector<StageTiming> fakeTimings = document.lastSaveTimings();
+    addSample(metrics, QStringLiteral("save_fake"), elapsedMs(timer), document.deletedCount(),
+              QFileInfo(document.saveTargetPath()).size());
+
+    document.setDryRun(false);
+    timer.restart();
+    if (!document.save()) {
+        QTextStream(stderr) << "real-delete save failed: " << document.lastError() << Qt::endl;
+        return false;
+    }
+    addSample(metrics, QStringLiteral("save_real"), elapsedMs(timer), document.deletedCount(),
+              QFileInfo(document.saveTargetPath()).size());
+
+    stages.insert(QStringLiteral("load"), timingsToJson(loadTimings));
+    stages.insert(QStringLiteral("save_fake"), timingsToJson(fakeTimings));
+    stages.insert(QStringLiteral("save_real"), timingsToJson(document.lastSaveTimings()));
+    return true;
+}
+
+/**
+ * @brief 界面部分：首屏时间（发起加载到布局就绪且网格建立）、网格构建（displayData），
+ *        以及 Ctrl+滚轮缩放一档并重绘的耗时。
+ */
+bool runGuiIteration(const BenchOptions& options, const QString& path, Metrics& metrics,
+                     QJsonObject& stages) {
+    XLSXEditor editor(nullptr, true);
+    editor.document()->setJournalEnabled(false);
+    editor.setProfilingEnabled(true);
+    if (!options.thumbnailCache) {
+        editor.setThumbnailCacheBudget(0);
+    }
+    editor.resize(1280, 900);
+    editor.show();
+
+    // 编辑器自身的 layoutReady 处理先连接，触发时网格已建立。
+    QElapsedTimer loadTimer;
+    double firstScreenMs = -1.0;
+    QObject::connect(editor.document(), &XLSXDocument::layoutReady, &editor,
+                     [&loadTimer, &firstScreenMs]() { firstScreenMs = elapsedMs(loadTimer); });
+    loadTimer.start();
+    editor.loadXLSX(path, QString::fromLatin1(kSheetName), rangeFor(options.spec));
+    if (editor.document()->entries().isEmpty()) {
+        QTextStream(stderr) << "editor load failed" << Qt::endl;
+        return false;
+    }
+    if (firstScreenMs >= 0.0) {
+        addSample(metrics, QStringLiteral("first_screen"), firstScreenMs,
+                  editor.document()->entries().size());
+    }
+    const QVector<StageTiming>& displayTimings = editor.lastDisplayTimings();
+    qint64 displayNs = 0;
+    for (const auto& timing : displayTimings) {
+        displayNs += timing.nsecs;
+    }
+    addSample(metrics, QStringLiteral("display"), displayNs / 1e6,
+              editor.document()->entries().size());
+    stages.insert(QStringLiteral("display"), timingsToJson(displayTimings));
+
+    auto* scrollArea = editor.findChild<QScrollArea*>();
+    if (!scrollArea) {
+        return true;
+    }
+    QWidget* viewport = scrollArea->viewport();
+    const QPointF center = QPointF(viewport->rect().center());
+    // 每一档缩放包含事件处理与一次完整重绘；先放大再缩小回原尺寸。
+    for (int step = 0; step < 2 * options.zoomSteps; ++step) {
+        const int delta = step < options.zoomSteps ? 120 : -120;
+        QWheelEvent wheel(center, viewport->mapToGlobal(center), QPoint(), QPoint(0, delta),
+                          Qt::NoButton, Qt::ControlModifier, Qt::NoScrollPhase, false);
+        QElapsedTimer timer;
+        timer.start();
+        QCoreApplication::sendEvent(viewport, &wheel);
+        editor.grab();
+        addSample(metrics, QStringLiteral("zoom"), elapsedMs(timer),
+                  editor.document()->entries().size());
+    }
+    return true;
+}
+
+QJsonObject summarize(const Metrics& metrics) {
+    QJsonObject results;
+    for (const auto& [name, metric] : metrics) {
+        std::vector<double> sorted = metric.samples;
+        std::sort(sorted.begin(), sorted.end());
+        const double median = sorted[sorted.size() / 2];
+        const double mean =
+            std::accumulate(sorted.begin(), sorted.end(), 0.0) / static_cast<double>(sorted.size());
+        QJsonArray samples;
+        for (const double sample : metric.samples) {
+            samples.append(sample);
+        }
+        QJsonObject object{{QStringLiteral("samples"), samples},
+                           {QStringLiteral("min_ms"), sorted.front()},
+                           {QStringLiteral("median_ms"), median},
+                           {QStringLiteral("mean_ms"), mean},
+                           {QStringLiteral("max_ms"), sorted.back()},
+                           {QStringLiteral("items"), metric.items},
+                           {QStringLiteral("bytes"), metric.bytes}};
+        if (median > 0.0 && metric.items > 0) {
+            object.insert(QStringLiteral("items_per_s"), metric.items / (median / 1000.0));
+        }
+        if (median > 0.0 && metric.bytes > 0) {
+            object.insert(QStringLiteral("mb_per_s"),
+                          metric.bytes / (1024.0 * 1024.0) / (median / 1000.0));
+        }
+        results.insert(name, object);
+    }
+    return results;
+}
+
+bool parseSize(const QString& text, QSize& size) {
+    const QStringList parts = text.split(QLatin1Char('x'));
+    if (parts.size() != 2) {
+        return false;
+    }
+    size = QSize(parts[0].toInt(), parts[1].toInt());
+    return size.width() > 0 && size.height() > 0;
+}
+
+void printUsage(const char* program) {
+    QTextStream err(stderr);
+    err << "Usage: " << program << " [options]\n"
+        << "  --rows N             Picture rows in the grid (default 14)\n"
+        << "  --cols N             Picture columns in the grid (default 10)\n"
+        << "  --image-size WxH     Picture size in pixels (default 640x480)\n"
+        << "  --format jpg|png     Picture format (default jpg)\n"
+        << "  --desc-density F     Fraction of pictures with a description (default 0.8)\n"
+        << "  --seed N             Generator seed (default 1)\n"
+        << "  --iterations N       Measured iterations (default 3)\n"
+        << "  --zoom-steps N       Ctrl+wheel steps in and out per iteration (default 5)\n"
+        << "  --no-gui             Skip the grid and zoom measurements\n"
+        << "  --thumbnail-cache    Keep the on-disk thumbnail cache (warm after iteration 1)\n"
+        << "  --output FILE        Write the JSON report to FILE instead of stdout\n"
+        << "  --generate-only FILE Only write the synthetic workbook to FILE\n";
+}
+
+bool parseArguments(const QStringList& args, BenchOptions& options) {
+    for (int i = 1; i < args.size(); ++i) {
+        const QString& arg = args[i];
+        const bool hasValue = i + 1 < args.size();
+        if (arg == QLatin1String("--no-gui")) {
+            options.gui = false;
+        } else if (arg == QLatin1String("--thumbnail-cache")) {
+            options.thumbnailCache = true;
+        } else if (!hasValue) {
+            return false;
+        } else if (arg == QLatin1String("--rows")) {
+            options.spec.rows = args[++i].toInt();
+        } else if (arg == QLatin1String("--cols")) {
+            options.spec.cols = args[++i].toInt();
+        } else if (arg == QLatin1String("--image-size")) {
+            if (!parseSize(args[++i], options.spec.imageSize)) {
+                return false;
+            }
+        } else if (arg == QLatin1String("--format")) {
+            options.spec.format = args[++i].toLatin1();
+        } else if (arg == QLatin1String("--desc-density")) {
+            options.spec.descDensity = args[++i].toDouble();
+        } else if (arg == QLatin1String("--seed")) {
+            options.spec.seed = args[++i].toUInt();
+        } else if (arg == QLatin1String("--iterations")) {
+            options.iterations = args[++i].toInt();
+        } else if (arg == QLatin1String("--zoom-steps")) {
+            options.zoomSteps = args[++i].toInt();
+        } else if (arg == QLatin1String("--output")) {
+            options.output = args[++i];
+        } else if (arg == QLatin1String("--generate-only")) {
+            options.generateOnly = args[++i];
+        } else {
+            return false;
+        }
+    }
+    return options.spec.rows > 0 && options.spec.cols > 0 && options.iterations > 0 &&
+           options.zoomSteps >= 0 &&
+           (options.spec.format == "jpg" || options.spec.format == "png");
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    // 默认不弹出窗口；需要观察界面时可显式设置 QT_QPA_PLATFORM。
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    BenchOptions options;
+    if (!parseArguments(QCoreApplication::arguments(), options)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    if (!options.generateOnly.isEmpty()) {
+        QString error;
+        if (!generateWorkbook(options.spec, options.generateOnly, error)) {
+            QTextStream(stderr) << "failed to write " << options.generateOnly << ": " << error
+                                << Qt::endl;
+            return 1;
+        }
+        QTextStream(stderr) << "range: " << rangeFor(options.spec) << ", sheet: " << kSheetName
+                            << Qt::endl;
+        return 0;
+    }
+
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        QTextStream(stderr) << "cannot create a temporary directory" << Qt::endl;
+        return 1;
+    }
+    const QString path = dir.filePath(QStringLiteral("synthetic.xlsx"));
+    QElapsedTimer timer;
+    timer.start();
+    QString error;
+    if (!generateWorkbook(options.spec, path, error)) {
+        QTextStream(stderr) << "failed to generate the synthetic workbook: " << error << Qt::endl;
+        return 1;
+    }
+    const double generateMs = elapsedMs(timer);
+
+    Metrics metrics;
+    QJsonArray iterations;
+    for (int i = 0; i < options.iterations; ++i) {
+        QJsonObject stages;
+        if (!runCoreIteration(options, path, metrics, stages)) {
+            return 1;
+        }
+        if (options.gui && !runGuiIteration(options, path, metrics, stages)) {
+            return 1;
+        }
+        iterations.append(stages);
+        QTextStream(stderr) << "iteration " << (i + 1) << "/" << options.iterations << " done"
+                            << Qt::endl;
+    }
+
+    const WorkbookSpec& spec = options.spec;
+    const QJsonObject report{
+        {QStringLiteral("workbook"),
+         QJsonObject{{QStringLiteral("rows"), spec.rows},
+                     {QStringLiteral("cols"), spec.cols},
+                     {QStringLiteral("pictures"), spec.rows * spec.cols},
+                     {QStringLiteral("image_width"), spec.imageSize.width()},
+                     {QStringLiteral("image_height"), spec.imageSize.height()},
+                     {QStringLiteral("format"), QString::fromLatin1(spec.format)},
+                     {QStringLiteral("desc_density"), spec.descDensity},
+                     {QStringLiteral("seed"), static_cast<qint64>(spec.seed)},
+                     {QStringLiteral("bytes"), QFileInfo(path).size()},
+                     {QStringLiteral("generate_ms"), generateMs}}},
+        {QStringLiteral("iterations"), options.iterations},
+        {QStringLiteral("thumbnail_cache"), options.thumbnailCache},
+        {QStringLiteral("results"), summarize(metrics)},
+        {QStringLiteral("stages"), iterations},
+    };
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+    if (options.output.isEmpty()) {
+        QTextStream(stdout) << json;
+        return 0;
+    }
+    QFile file(options.output);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) < 0) {
+        QTextStream(stderr) << "cannot write " << options.output << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
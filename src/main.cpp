@@ -52,15 +52,17 @@ int main(int argc, char* argv[]) {
 
         if (autoTest) {
             QTimer::singleShot(500, editor, [editor]() {
-                // 通过触发每个 DataItem 的按钮来批量切换删除状态
-                QList<QWidget*> items = editor->findChildren<QWidget*>("dataItem");
-                for (auto* item : items) {
-                    // 模拟点击组件内按钮（用于自动化流程验证）
-                    QList<QPushButton*> btns = item->findChildren<QPushButton*>();
-                    if (!btns.isEmpty()) {
-                        btns[0]->click();
-                    }
+                // 网格不再为每项创建组件，经文档逐项切换删除状态（与双击描述相同的路径）
+                XLSXDocument* document = editor->document();
+                const int count = static_cast<int>(document->entries().size());
+                if (count == 0) {
+                    qWarning("auto-test: no entries loaded");
+                }
+                for (int i = 0; i < count; ++i) {
+                    document->setDeleted(i, !document->entries()[i].deleted);
                 }
+                qInfo("auto-test: toggled %d entries, %d marked deleted", count,
+                      document->deletedCount());
 
                 // 标记完成后触发保存
                 QTimer::singleShot(500, editor, [editor]() {
@@ -0,0 +1,393 @@
+#include <QTemporaryDir>
+#include <QtTest>
+#include <map>
+#include <set>
+#include <string>
+
+#include "cc/neolux/fem/xlsxeditor/CellTable.hpp"
+#include "cc/neolux/fem/xlsxeditor/XLSXPackage.hpp"
+#include "cc/neolux/fem/xlsxeditor/ZipWriter.hpp"
+
+using namespace cc::neolux::fem::xlsxeditor;
+
+namespace {
+using Parts = std::map<std::string, std::string>;
+
+constexpr const char* kXmlDecl = "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n";
+constexpr const char* kRelNs = "http://schemas.openxmlformats.org/package/2006/relationships";
+constexpr const char* kOfficeRel =
+    "http://schemas.openxmlformats.org/officeDocument/2006/relationships/";
+constexpr const char* kSheetNs = "http://schemas.openxmlformats.org/spreadsheetml/2006/main";
+
+std::string relationship(const std::string& id, const std::string& type,
+                         const std::string& target) {
+    return "<Relationship Id=\"" + id + "\" Type=\"" + kOfficeRel + type + "\" Target=\"" +
+           target + "\"/>";
+}
+
+std::string relationships(const std::string& body) {
+    return std::string(kXmlDecl) + "<Relationships xmlns=\"" + kRelNs + "\">" + body +
+           "</Relationships>";
+}
+
+std::string anchor(int row, int col, const std::string& rid) {
+    return "<xdr:twoCellAnchor><xdr:from><xdr:col>" + std::to_string(col - 1) +
+           "</xdr:col><xdr:colOff>0</xdr:colOff><xdr:row>" + std::to_string(row - 1) +
+           "</xdr:row><xdr:rowOff>0</xdr:rowOff></xdr:from><xdr:to><xdr:col>" +
+           std::to_string(col) + "</xdr:col><xdr:colOff>0</xdr:colOff><xdr:row>" +
+           std::to_string(row) +
+           "</xdr:row><xdr:rowOff>0</xdr:rowOff></xdr:to><xdr:pic><xdr:nvPicPr>"
+           "<xdr:cNvPr id=\"2\" name=\"Picture\"/><xdr:cNvPicPr/></xdr:nvPicPr>"
+           "<xdr:blipFill><a:blip r:embed=\"" +
+           rid + "\"/></xdr:blipFill></xdr:pic><xdr:clientData/></xdr:twoCellAnchor>";
+}
+
+/**
+ * @brief 最小工作簿：一张工作表，含普通值、公式、共享公式与带样式的单元格，
+ *        B2、C2 与 C4 各锚定一张图片（C2 与 C4 共用 image2.png）。
+ * @param calcChain calcChain.xml 的 <c> 条目，空串表示没有计算链。
+ */
+Parts workbookParts(bool withStyles, const std::string& calcChain) {
+    Parts parts;
+    std::string overrides =
+        "<Override PartName=\"/xl/workbook.xml\" ContentType=\"application/"
+        "vnd.openxmlformats-officedocument.spreadsheetml.sheet.main+xml\"/>"
+        "<Override PartName=\"/xl/worksheets/sheet1.xml\" ContentType=\"application/"
+        "vnd.openxmlformats-officedocument.spreadsheetml.worksheet+xml\"/>"
+        "<Override PartName=\"/xl/drawings/drawing1.xml\" ContentType=\"application/"
+        "vnd.openxmlformats-officedocument.drawing+xml\"/>";
+    std::string workbookRels = relationship("rId1", "worksheet", "worksheets/sheet1.xml");
+
+    if (withStyles) {
+        overrides += "<Override PartName=\"/xl/styles.xml\" ContentType=\"application/"
+                     "vnd.openxmlformats-officedocument.spreadsheetml.styles+xml\"/>";
+        workbookRels += relationship("rId2", "styles", "styles.xml");
+        parts["xl/styles.xml"] =
+            std::string(kXmlDecl) + "<styleSheet xmlns=\"" + kSheetNs +
+            "\"><fills count=\"2\"><fill><patternFill patternType=\"none\"/></fill>"
+            "<fill><patternFill patternType=\"gray125\"/></fill></fills>"
+            "<cellXfs count=\"2\"><xf numFmtId=\"0\" fontId=\"0\" fillId=\"0\" borderId=\"0\"/>"
+            "<xf numFmtId=\"14\" fontId=\"0\" fillId=\"0\" borderId=\"0\" "
+            "applyNumberFormat=\"1\"/></cellXfs></styleSheet>";
+    }
+    if (!calcChain.empty()) {
+        overrides += "<Override PartName=\"/xl/calcChain.xml\" ContentType=\"application/"
+                     "vnd.openxmlformats-officedocument.spreadsheetml.calcChain+xml\"/>";
+        workbookRels += relationship("rId3", "calcChain", "calcChain.xml");
+        parts["xl/calcChain.xml"] = std::string(kXmlDecl) + "<calcChain xmlns=\"" + kSheetNs +
+                                    "\">" + calcChain + "</calcChain>";
+    }
+
+    parts["[Content_Types].xml"] =
+        std::string(kXmlDecl) +
+        "<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/content-types\">"
+        "<Default Extension=\"rels\" ContentType=\"application/"
+        "vnd.openxmlformats-package.relationships+xml\"/>"
+        "<Default Extension=\"xml\" ContentType=\"application/xml\"/>"
+        "<Default Extension=\"png\" ContentType=\"image/png\"/>" +
+        overrides + "</Types>";
+    parts["_rels/.rels"] = relationships(relationship("rId1", "officeDocument", "xl/workbook.xml"));
+    parts["xl/workbook.xml"] =
+        std::string(kXmlDecl) + "<workbook xmlns=\"" + kSheetNs + "\" xmlns:r=\"" +
+        "http://schemas.openxmlformats.org/officeDocument/2006/relationships\"><sheets>"
+        "<sheet name=\"Sheet1\" sheetId=\"1\" r:id=\"rId1\"/></sheets></workbook>";
+    parts["xl/_rels/workbook.xml.rels"] = relationships(workbookRels);
+    parts["xl/worksheets/sheet1.xml"] =
+        std::string(kXmlDecl) + "<worksheet xmlns=\"" + kSheetNs +
+        "\" xmlns:r=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships\">"
+        "<sheetData>"
+        "<row r=\"1\"><c r=\"A1\"><v>1</v></c><c r=\"B1\"><f>A1*2</f><v>2</v></c>"
+        "<c r=\"C1\"><f t=\"shared\" ref=\"C1:C2\" si=\"0\">A1</f><v>1</v></c></row>"
+        "<row r=\"2\"><c r=\"C2\"><f t=\"shared\" si=\"0\"/><v>0</v></c></row>"
+        "<row r=\"3\"><c r=\"B3\" s=\"1\"><v>45000</v></c></row>"
+        "<row r=\"5\"><c r=\"B5\" s=\"1\"><v>45001</v></c></row>"
+        "</sheetData><drawing r:id=\"rId1\"/></worksheet>";
+    parts["xl/worksheets/_rels/sheet1.xml.rels"] =
+        relationships(relationship("rId1", "drawing", "../drawings/drawing1.xml"));
+    parts["xl/drawings/drawing1.xml"] =
+        std::string(kXmlDecl) +
+        "<xdr:wsDr xmlns:xdr=\"http://schemas.openxmlformats.org/drawingml/2006/"
+        "spreadsheetDrawing\" xmlns:a=\"http://schemas.openxmlformats.org/drawingml/2006/main\" "
+        "xmlns:r=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships\">" +
+        anchor(2, 2, "rId1") + anchor(2, 3, "rId2") + anchor(4, 3, "rId3") + "</xdr:wsDr>";
+    parts["xl/drawings/_rels/drawing1.xml.rels"] =
+        relationships(relationship("rId1", "image", "../media/image1.png") +
+                      relationship("rId2", "image", "../media/image2.png") +
+                      relationship("rId3", "image", "../media/image2.png"));
+    parts["xl/media/image1.png"] = "not really a png 1";
+    parts["xl/media/image2.png"] = "not really a png 2";
+    return parts;
+}
+
+bool writeParts(const QString& path, const Parts& parts) {
+    ZipWriter zip;
+    if (!zip.open(path.toStdString())) {
+        return false;
+    }
+    for (const auto& [name, data] : parts) {
+        if (!zip.add(name, data)) {
+            return false;
+        }
+    }
+    return zip.finish();
+}
+
+std::string partText(const XLSXPackage& package, const std::string& name) {
+    std::string out;
+    package.readPart(name, out);
+    return out;
+}
+
+bool contains(const std::string& text, const std::string& needle) {
+    return text.find(needle) != std::string::npos;
+}
+}  // namespace
+
+/** @brief PackageRewriter 在合成工作簿上的往返测试：改写、写出、再打开校验。 */
+class TestPackageRewriter : public QObject {
+    Q_OBJECT
+
+private:
+    QTemporaryDir m_dir;
+
+    QString sourcePath(const Parts& parts) {
+        const QString path = m_dir.filePath(QStringLiteral("source.xlsx"));
+        QFile::remove(path);
+        return writeParts(path, parts) ? path : QString();
+    }
+
+    QString targetPath() {
+        const QString path = m_dir.filePath(QStringLiteral("target.xlsx"));
+        QFile::remove(path);
+        return path;
+    }
+
+private slots:
+    void initTestCase() { QVERIFY(m_dir.isValid()); }
+
+    void writeCellsAsInlineStrings() {
+        XLSXPackage source;
+        QVERIFY(source.open(sourcePath(workbookParts(true, "")).toStdString()));
+        PackageRewriter rewriter(source);
+        QVERIFY(rewriter.writeCells(0, {{1, 1, "replaced", ""}, {4, 2, " padded ", ""}}));
+        const QString target = targetPath();
+        QVERIFY(rewriter.write(target.toStdString()));
+
+        XLSXPackage result;
+        QVERIFY(result.open(target.toStdString()));
+        CellTable table;
+        QVERIFY(result.readCells(0, {{1, 1, 5, 3}}, table));
+        QCOMPARE(table.text(1, 1), std::string("replaced"));
+        QCOMPARE(table.text(4, 2), std::string(" padded "));
+        QCOMPARE(table.text(1, 2), std::string("2"));
+
+        const std::string sheet = partText(result, "xl/worksheets/sheet1.xml");
+        QVERIFY(contains(sheet, "<c r=\"A1\" t=\"inlineStr\"><is><t>replaced</t></is></c>"));
+        QVERIFY(contains(sheet, "<t xml:space=\"preserve\"> padded </t>"));
+        // 新行按行号插入到第 3 行与第 5 行之间
+        QVERIFY(sheet.find("<row r=\"4\">") > sheet.find("<row r=\"3\">"));
+        QVERIFY(sheet.find("<row r=\"4\">") < sheet.find("<row r=\"5\">"));
+        // 未改动的部件原样复制
+        QCOMPARE(partText(result, "xl/media/image1.png"), std::string("not really a png 1"));
+    }
+
+    void writeCellsClonesFillStyles() {
+        XLSXPackage source;
+        QVERIFY(source.open(sourcePath(workbookParts(true, "")).toStdString()));
+        PackageRewriter rewriter(source);
+        QVERIFY(rewriter.writeCells(0, {{3, 2, "a", "FFFF0000"},
+                                        {5, 2, "b", "FFFF0000"},
+                                        {6, 1, "c", "FFFF0000"}}));
+        const QString target = targetPath();
+        QVERIFY(rewriter.write(target.toStdString()));
+
+        XLSXPackage result;
+        QVERIFY(result.open(target.toStdString()));
+        CellTable table;
+        QVERIFY(result.readCells(0, {{1, 1, 6, 3}}, table));
+        // 相同 (原样式, 颜色) 只克隆一次：B3 与 B5 共用样式 2，默认样式的 A6 克隆为样式 3
+        QCOMPARE(table.styleIndex(3, 2), 2);
+        QCOMPARE(table.styleIndex(5, 2), 2);
+        QCOMPARE(table.styleIndex(6, 1), 3);
+
+        const std::vector<bool> filled = result.filledStyles();
+        QCOMPARE(filled.size(), size_t(4));
+        QVERIFY(!filled[0] && !filled[1] && filled[2] && filled[3]);
+        const std::string styles = partText(result, "xl/styles.xml");
+        QVERIFY(contains(styles, "<fills count=\"3\">"));
+        QVERIFY(contains(styles, "<fgColor rgb=\"FFFF0000\"/>"));
+        // 克隆保留原样式的数字格式
+        QVERIFY(contains(styles, "<xf numFmtId=\"14\" fontId=\"0\" fillId=\"2\" borderId=\"0\" "
+                                 "applyNumberFormat=\"1\" applyFill=\"1\"/>"));
+
+        // 再次改写时清除填充：克隆出的样式不再带填充
+        PackageRewriter clearing(result);
+        QVERIFY(clearing.writeCells(0, {{3, 2, "a", ""}, {6, 1, "c", ""}}));
+        const QString cleared = m_dir.filePath(QStringLiteral("cleared.xlsx"));
+        QFile::remove(cleared);
+        QVERIFY(clearing.write(cleared.toStdString()));
+        XLSXPackage clearedPackage;
+        QVERIFY(clearedPackage.open(cleared.toStdString()));
+        table.clear();
+        QVERIFY(clearedPackage.readCells(0, {{1, 1, 6, 3}}, table));
+        const std::vector<bool> clearedFills = clearedPackage.filledStyles();
+        for (const auto& [row, col] : {std::pair{3, 2}, std::pair{6, 1}}) {
+            const int style = table.styleIndex(row, col);
+            QVERIFY(style >= 0 && style < static_cast<int>(clearedFills.size()));
+            QVERIFY(!clearedFills[style]);
+        }
+    }
+
+    void writeCellsWithoutStylesPart() {
+        XLSXPackage source;
+        QVERIFY(source.open(sourcePath(workbookParts(false, "")).toStdString()));
+        QVERIFY(source.stylesPath().empty());
+
+        PackageRewriter rewriter(source);
+        // 不涉及填充的改写不需要样式表
+        QVERIFY(rewriter.writeCells(0, {{3, 2, "text only", ""}, {7, 1, "new", ""}}));
+        const QString target = targetPath();
+        QVERIFY(rewriter.write(target.toStdString()));
+        XLSXPackage result;
+        QVERIFY(result.open(target.toStdString()));
+        CellTable table;
+        QVERIFY(result.readCells(0, {{1, 1, 7, 3}}, table));
+        QCOMPARE(table.text(3, 2), std::string("text only"));
+        QCOMPARE(table.text(7, 1), std::string("new"));
+
+        // 设置填充必须有样式表，失败时不暂存任何改动
+        PackageRewriter filling(source);
+        QVERIFY(!filling.writeCells(0, {{3, 2, "x", "FFFF0000"}}));
+        QVERIFY(!filling.isModified());
+    }
+
+    void writeCellsUpdatesCalcChain() {
+        XLSXPackage source;
+        QVERIFY(source.open(
+            sourcePath(workbookParts(true, "<c r=\"B1\" i=\"1\"/><c r=\"C2\"/><c r=\"C1\"/>"))
+                .toStdString()));
+        PackageRewriter rewriter(source);
+        QVERIFY(rewriter.writeCells(0, {{1, 2, "no formula", ""}}));
+        const QString target = targetPath();
+        QVERIFY(rewriter.write(target.toStdString()));
+
+        XLSXPackage result;
+        QVERIFY(result.open(target.toStdString()));
+        const std::string sheet = partText(result, "xl/worksheets/sheet1.xml");
+        QVERIFY(contains(sheet, "<c r=\"B1\" t=\"inlineStr\"><is><t>no formula</t></is></c>"));
+        // 被删条目的 i 转交给省略 i 的后继条目
+        const std::string chain = partText(result, "xl/calcChain.xml");
+        QVERIFY(!contains(chain, "\"B1\""));
+        QVERIFY(contains(chain, "<c r=\"C2\" i=\"1\"/><c r=\"C1\"/>"));
+    }
+
+    void writeCellsRemovesEmptyCalcChain() {
+        XLSXPackage source;
+        QVERIFY(source.open(sourcePath(workbookParts(true, "<c r=\"B1\" i=\"1\"/><c r=\"C2\"/>"))
+                                .toStdString()));
+        PackageRewriter rewriter(source);
+        // 共享公式的从属单元格可以覆盖
+        QVERIFY(rewriter.writeCells(0, {{1, 2, "x", ""}, {2, 3, "y", ""}}));
+        const QString target = targetPath();
+        QVERIFY(rewriter.write(target.toStdString()));
+
+        XLSXPackage result;
+        QVERIFY(result.open(target.toStdString()));
+        QVERIFY(result.archive().find("xl/calcChain.xml") == nullptr);
+        QVERIFY(result.calcChainPath().empty());
+        QVERIFY(!contains(partText(result, "[Content_Types].xml"), "calcChain"));
+        QVERIFY(!result.stylesPath().empty());
+    }
+
+    void writeCellsRefusesSharedFormulaMaster() {
+        XLSXPackage source;
+        const QString path = sourcePath(workbookParts(true, "<c r=\"C1\" i=\"1\"/>"));
+        QVERIFY(source.open(path.toStdString()));
+        PackageRewriter rewriter(source);
+        QVERIFY(!rewriter.writeCells(0, {{1, 1, "a", ""}, {1, 3, "master", ""}}));
+        QVERIFY(!rewriter.isModified());
+    }
+
+    void removePicturesKeepsSharedMedia() {
+        XLSXPackage source;
+        QVERIFY(source.open(sourcePath(workbookParts(true, "")).toStdString()));
+        QCOMPARE(source.sheetPictures(0).size(), size_t(3));
+
+        PackageRewriter rewriter(source);
+        QVERIFY(rewriter.removePictures(0, {{2, 2}, {2, 3}}));
+        const QString target = targetPath();
+        QVERIFY(rewriter.write(target.toStdString()));
+
+        XLSXPackage result;
+        QVERIFY(result.open(target.toStdString()));
+        const std::vector<PictureAnchor> pictures = result.sheetPictures(0);
+        QCOMPARE(pictures.size(), size_t(1));
+        QCOMPARE(pictures[0].rowNum, 4);
+        QCOMPARE(pictures[0].colNum, 3);
+        QCOMPARE(pictures[0].mediaPath, std::string("xl/media/image2.png"));
+        // image1 已无引用被删除；image2 仍被 C4 的锚点引用
+        QVERIFY(result.archive().find("xl/media/image1.png") == nullptr);
+        QCOMPARE(partText(result, "xl/media/image2.png"), std::string("not really a png 2"));
+        const std::string rels = partText(result, "xl/drawings/_rels/drawing1.xml.rels");
+        QVERIFY(!contains(rels, "\"rId1\"") && !contains(rels, "\"rId2\""));
+        QVERIFY(contains(rels, "\"rId3\""));
+    }
+
+    void removePicturesKeepsSharedRelationship() {
+        // Excel 对重复出现的同一图片复用 rId：B2 与 D3 共用 rId1，D5 的组合形状内引用 rId2。
+        const std::string group =
+            "<xdr:twoCellAnchor><xdr:from><xdr:col>3</xdr:col><xdr:colOff>0</xdr:colOff>"
+            "<xdr:row>4</xdr:row><xdr:rowOff>0</xdr:rowOff></xdr:from><xdr:to><xdr:col>4"
+            "</xdr:col><xdr:colOff>0</xdr:colOff><xdr:row>5</xdr:row><xdr:rowOff>0</xdr:rowOff>"
+            "</xdr:to><xdr:grpSp><xdr:nvGrpSpPr><xdr:cNvPr id=\"9\" name=\"Group\"/>"
+            "<xdr:cNvGrpSpPr/></xdr:nvGrpSpPr><xdr:grpSpPr/><xdr:pic><xdr:nvPicPr>"
+            "<xdr:cNvPr id=\"10\" name=\"Grouped\"/><xdr:cNvPicPr/></xdr:nvPicPr>"
+            "<xdr:blipFill><a:blip r:embed=\"rId2\"/></xdr:blipFill></xdr:pic></xdr:grpSp>"
+            "<xdr:clientData/></xdr:twoCellAnchor>";
+        Parts parts = workbookParts(true, "");
+        parts["xl/drawings/drawing1.xml"] =
+            std::string(kXmlDecl) +
+            "<xdr:wsDr xmlns:xdr=\"http://schemas.openxmlformats.org/drawingml/2006/"
+            "spreadsheetDrawing\" xmlns:a=\"http://schemas.openxmlformats.org/drawingml/2006/"
+            "main\" xmlns:r=\"http://schemas.openxmlformats.org/officeDocument/2006/"
+            "relationships\">" +
+            anchor(2, 2, "rId1") + anchor(3, 4, "rId1") + anchor(2, 3, "rId2") + group +
+            "</xdr:wsDr>";
+        parts["xl/drawings/_rels/drawing1.xml.rels"] =
+            relationships(relationship("rId1", "image", "../media/image1.png") +
+                          relationship("rId2", "image", "../media/image2.png"));
+
+        XLSXPackage source;
+        QVERIFY(source.open(sourcePath(parts).toStdString()));
+        PackageRewriter rewriter(source);
+        QVERIFY(rewriter.removePictures(0, {{2, 2}, {2, 3}}));
+        const QString target = targetPath();
+        QVERIFY(rewriter.write(target.toStdString()));
+
+        XLSXPackage result;
+        QVERIFY(result.open(target.toStdString()));
+        const std::vector<PictureAnchor> pictures = result.sheetPictures(0);
+        QCOMPARE(pictures.size(), size_t(1));
+        QCOMPARE(pictures[0].rowNum, 3);
+        QCOMPARE(pictures[0].colNum, 4);
+        QCOMPARE(pictures[0].mediaPath, std::string("xl/media/image1.png"));
+        // 两个关系仍被保留的锚点引用，关系与图片都不能删除
+        const std::string rels = partText(result, "xl/drawings/_rels/drawing1.xml.rels");
+        QVERIFY(contains(rels, "\"rId1\"") && contains(rels, "\"rId2\""));
+        QCOMPARE(partText(result, "xl/media/image1.png"), std::string("not really a png 1"));
+        QCOMPARE(partText(result, "xl/media/image2.png"), std::string("not really a png 2"));
+        const std::string drawing = partText(result, "xl/drawings/drawing1.xml");
+        QVERIFY(contains(drawing, "<xdr:grpSp>"));
+    }
+
+    void removePicturesWithoutMatchIsNoop() {
+        XLSXPackage source;
+        QVERIFY(source.open(sourcePath(workbookParts(true, "")).toStdString()));
+        PackageRewriter rewriter(source);
+        QVERIFY(rewriter.removePictures(0, {{9, 9}}));
+        QVERIFY(!rewriter.isModified());
+    }
+};
+
+QTEST_GUILESS_MAIN(TestPackageRewriter)
+#include "tst_PackageRewriter.moc"
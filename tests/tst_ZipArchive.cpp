@@ -0,0 +1,232 @@
+#include <zlib.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtTest>
+#include <cstdint>
+#include <string>
+
+#include "cc/neolux/fem/xlsxeditor/ZipArchive.hpp"
+#include "cc/neolux/fem/xlsxeditor/ZipWriter.hpp"
+
+using namespace cc::neolux::fem::xlsxeditor;
+
+namespace {
+void putU16(std::string& out, uint16_t value) {
+    out += static_cast<char>(value & 0xFF);
+    out += static_cast<char>(value >> 8);
+}
+
+void putU32(std::string& out, uint32_t value) {
+    putU16(out, static_cast<uint16_t>(value & 0xFFFF));
+    putU16(out, static_cast<uint16_t>(value >> 16));
+}
+
+void putU64(std::string& out, uint64_t value) {
+    putU32(out, static_cast<uint32_t>(value & 0xFFFFFFFFu));
+    putU32(out, static_cast<uint32_t>(value >> 32));
+}
+
+/**
+ * @brief 手工构造只含一个 stored 条目的 Zip64 归档。
+ *
+ * 本地头与中央目录的 32 位尺寸、偏移全部写成 0xFFFFFFFF 占位，真实值放在 Zip64 扩展字段；
+ * 结尾使用 Zip64 EOCD 记录与定位器。小文件即可覆盖读取端的全部 Zip64 分支。
+ */
+std::string zip64Archive(const std::string& name, const std::string& data) {
+    const uint32_t crc = static_cast<uint32_t>(
+        crc32(0L, reinterpret_cast<const Bytef*>(data.data()), static_cast<uInt>(data.size())));
+
+    std::string zip;
+    putU32(zip, 0x04034b50);
+    putU16(zip, 45);
+    putU16(zip, 0);  // flags
+    putU16(zip, 0);  // stored
+    putU32(zip, 0);  // 修改时间与日期
+    putU32(zip, crc);
+    putU32(zip, 0xFFFFFFFFu);
+    putU32(zip, 0xFFFFFFFFu);
+    putU16(zip, static_cast<uint16_t>(name.size()));
+    putU16(zip, 20);
+    zip += name;
+    putU16(zip, 0x0001);
+    putU16(zip, 16);
+    putU64(zip, data.size());
+    putU64(zip, data.size());
+    zip += data;
+
+    const uint64_t cdOffset = zip.size();
+    putU32(zip, 0x02014b50);
+    putU16(zip, 45);
+    putU16(zip, 45);
+    putU16(zip, 0);
+    putU16(zip, 0);
+    putU32(zip, 0);
+    putU32(zip, crc);
+    putU32(zip, 0xFFFFFFFFu);
+    putU32(zip, 0xFFFFFFFFu);
+    putU16(zip, static_cast<uint16_t>(name.size()));
+    putU16(zip, 28);
+    putU16(zip, 0);  // comment
+    putU16(zip, 0);  // disk
+    putU16(zip, 0);  // internal attributes
+    putU32(zip, 0);  // external attributes
+    putU32(zip, 0xFFFFFFFFu);
+    zip += name;
+    putU16(zip, 0x0001);
+    putU16(zip, 24);
+    putU64(zip, data.size());
+    putU64(zip, data.size());
+    putU64(zip, 0);  // 本地头偏移
+    const uint64_t cdSize = zip.size() - cdOffset;
+
+    const uint64_t zip64EocdOffset = zip.size();
+    putU32(zip, 0x06064b50);
+    putU64(zip, 44);
+    putU16(zip, 45);
+    putU16(zip, 45);
+    putU32(zip, 0);
+    putU32(zip, 0);
+    putU64(zip, 1);
+    putU64(zip, 1);
+    putU64(zip, cdSize);
+    putU64(zip, cdOffset);
+
+    putU32(zip, 0x07064b50);
+    putU32(zip, 0);
+    putU64(zip, zip64EocdOffset);
+    putU32(zip, 1);
+
+    putU32(zip, 0x06054b50);
+    putU16(zip, 0);
+    putU16(zip, 0);
+    putU16(zip, 0xFFFF);
+    putU16(zip, 0xFFFF);
+    putU32(zip, 0xFFFFFFFFu);
+    putU32(zip, 0xFFFFFFFFu);
+    putU16(zip, 0);
+    return zip;
+}
+
+bool writeFile(const QString& path, const std::string& bytes) {
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly | QIODevice::Truncate) &&
+           file.write(bytes.data(), static_cast<qint64>(bytes.size())) ==
+               static_cast<qint64>(bytes.size());
+}
+}  // namespace
+
+/** @brief ZipArchive / ZipWriter 的 Zip64 往返测试。 */
+class TestZipArchive : public QObject {
+    Q_OBJECT
+
+private:
+    QTemporaryDir m_dir;
+
+private slots:
+    void initTestCase() { QVERIFY(m_dir.isValid()); }
+
+    void readsZip64ExtraFields() {
+        const QString path = m_dir.filePath(QStringLiteral("zip64.zip"));
+        QVERIFY(writeFile(path, zip64Archive("xl/media/image1.png", "zip64 payload")));
+
+        ZipArchive archive;
+        QVERIFY(archive.open(path.toStdString()));
+        QCOMPARE(archive.entries().size(), size_t(1));
+        const ZipArchive::Entry* entry = archive.find("xl/media/image1.png");
+        QVERIFY(entry != nullptr);
+        QCOMPARE(entry->uncompressedSize, uint64_t(13));
+        QCOMPARE(entry->compressedSize, uint64_t(13));
+        QCOMPARE(entry->localHeaderOffset, uint64_t(0));
+        std::string data;
+        QVERIFY(archive.read(*entry, data));
+        QCOMPARE(data, std::string("zip64 payload"));
+    }
+
+    void copiesZip64EntriesRaw() {
+        const QString source = m_dir.filePath(QStringLiteral("zip64-source.zip"));
+        QVERIFY(writeFile(source, zip64Archive("a.txt", "raw copied")));
+        ZipArchive archive;
+        QVERIFY(archive.open(source.toStdString()));
+
+        // 原样复制压缩数据时必须以本地头（含 Zip64 扩展字段）定位数据起点
+        const QString target = m_dir.filePath(QStringLiteral("zip64-copy.zip"));
+        ZipWriter writer;
+        QVERIFY(writer.open(target.toStdString()));
+        QVERIFY(writer.addRaw(archive, archive.entries().front()));
+        QVERIFY(writer.add("b.txt", "added"));
+        QVERIFY(writer.finish());
+
+        ZipArchive copy;
+        QVERIFY(copy.open(target.toStdString()));
+        QCOMPARE(copy.entries().size(), size_t(2));
+        std::string data;
+        QVERIFY(copy.read("a.txt", data));
+        QCOMPARE(data, std::string("raw copied"));
+        QVERIFY(copy.read("b.txt", data));
+        QCOMPARE(data, std::string("added"));
+    }
+
+    void rejectsImplausibleUncompressedSize() {
+        const QString path = m_dir.filePath(QStringLiteral("bogus-size.zip"));
+        {
+            ZipWriter writer;
+            QVERIFY(writer.open(path.toStdString()));
+            QVERIFY(writer.add("a.txt", std::string(1000, 'x')));
+            QVERIFY(writer.finish());
+        }
+
+        // 把中央目录中的解压后尺寸改成约 2 GiB：读取应直接失败，而不是按此分配内存
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QByteArray bytes = file.readAll();
+        const qsizetype central = bytes.indexOf(QByteArray("PK\x01\x02", 4));
+        QVERIFY(central >= 0);
+        bytes.replace(central + 24, 4, QByteArray("\xFF\xFF\xFF\x7F", 4));
+        QVERIFY(file.seek(0));
+        QVERIFY(file.write(bytes) == bytes.size());
+        file.close();
+
+        ZipArchive archive;
+        QVERIFY(archive.open(path.toStdString()));
+        const ZipArchive::Entry* entry = archive.find("a.txt");
+        QVERIFY(entry != nullptr);
+        QCOMPARE(entry->uncompressedSize, uint64_t(0x7FFFFFFF));
+        std::string data;
+        QVERIFY(!archive.read(*entry, data));
+        QVERIFY(data.empty());
+    }
+
+    void writesZip64EndOfCentralDirectory() {
+        // 条目数达到 0xFFFF 时 EOCD 只能写占位值，真实数量记录在 Zip64 EOCD 中
+        constexpr int kEntryCount = 0x10000 + 16;
+        const QString path = m_dir.filePath(QStringLiteral("many.zip"));
+        {
+            ZipWriter writer;
+            QVERIFY(writer.open(path.toStdString()));
+            for (int i = 0; i < kEntryCount; ++i) {
+                QVERIFY(writer.add("e/" + std::to_string(i), std::to_string(i * 7)));
+            }
+            QVERIFY(writer.finish());
+        }
+
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QVERIFY(file.seek(file.size() - 22));
+        const QByteArray eocd = file.read(22);
+        QCOMPARE(static_cast<uint8_t>(eocd[10]), uint8_t(0xFF));
+        QCOMPARE(static_cast<uint8_t>(eocd[11]), uint8_t(0xFF));
+
+        ZipArchive archive;
+        QVERIFY(archive.open(path.toStdString()));
+        QCOMPARE(archive.entries().size(), size_t(kEntryCount));
+        std::string data;
+        QVERIFY(archive.read("e/0", data));
+        QCOMPARE(data, std::string("0"));
+        QVERIFY(archive.read("e/" + std::to_string(kEntryCount - 1), data));
+        QCOMPARE(data, std::to_string((kEntryCount - 1) * 7));
+    }
+};
+
+QTEST_GUILESS_MAIN(TestZipArchive)
+#include "tst_ZipArchive.moc"